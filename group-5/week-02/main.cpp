@@ -1,16 +1,169 @@
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <new>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 using std::string;
 
-template <typename T, typename I>
-T* map(const I* arr, int size, T (*func)(I)) { 
-    T* result = new T[size];
+// Array returned by map(). The elements are constructed directly in raw
+// memory from the results of the function, so T does not need a default
+// constructor and nothing is constructed twice (as with `new T[size]`
+// followed by assignment).
+template <typename T>
+class MappedArray {
+public:
+    MappedArray(const MappedArray&) = delete;
+    MappedArray& operator=(const MappedArray&) = delete;
 
-    for (int i = 0; i < size; ++i) {
-        result[i] = func(arr[i]);
+    MappedArray(MappedArray&& other) : data(other.data), size(other.size) {
+        other.data = nullptr;
+        other.size = 0;
     }
 
+    ~MappedArray() {
+        std::destroy_n(data, size);
+        ::operator delete(data, std::align_val_t(alignof(T)));
+    }
+
+    std::size_t get_size() const {
+        return size;
+    }
+
+    T& operator[](std::size_t index) {
+        return data[index];
+    }
+
+    const T& operator[](std::size_t index) const {
+        return data[index];
+    }
+
+    T* begin() {
+        return data;
+    }
+
+    T* end() {
+        return data + size;
+    }
+
+private:
+    template <typename I, typename F>
+    friend auto map(const I* arr, std::size_t size, F func);
+
+    // Allocates room for `capacity` elements without constructing them
+    explicit MappedArray(std::size_t capacity)
+        : data(static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))))), size(0) {}
+
+    T* data;
+    std::size_t size; // number of constructed elements
+};
+
+// Constructs out[i] = func(arr[i]) for i in [0, size). If func throws, the
+// elements constructed so far are destroyed and `constructed` is left
+// unchanged; otherwise it is set to size.
+template <typename T, typename I, typename F>
+void map_range(const I* arr, T* out, std::size_t size, F& func, std::size_t& constructed) {
+    std::size_t i = 0;
+    try {
+        // A plain indexed loop: for simple types and functions the compiler
+        // can inline func and vectorize it
+        for (; i < size; ++i) {
+            std::construct_at(out + i, func(arr[i]));
+        }
+    } catch (...) {
+        std::destroy_n(out, i);
+        throw;
+    }
+    constructed = size;
+}
+
+// Below this many elements starting threads costs more than it saves
+constexpr std::size_t parallel_threshold = 1 << 15;
+
+// Returns an array with func(arr[0]), ..., func(arr[size - 1]).
+//
+// func may be any callable - a function, a lambda or a functor - and may
+// return a type different from I. Large inputs are split into one contiguous
+// chunk per hardware thread and the chunks are processed in parallel. All
+// threads call the same func object, so it must be safe to call from several
+// threads at once.
+//
+// If func throws, the exception is passed on to the caller (after all
+// threads have finished) and no result is returned.
+template <typename I, typename F>
+auto map(const I* arr, std::size_t size, F func) {
+    using T = std::remove_cvref_t<std::invoke_result_t<F&, const I&>>;
+
+    MappedArray<T> result(size);
+
+    std::size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    if (size < parallel_threshold || thread_count == 1) {
+        map_range(arr, result.data, size, func, result.size);
+        return result;
+    }
+
+    thread_count = std::min(thread_count, size / (parallel_threshold / 4));
+    std::size_t chunk_size = (size + thread_count - 1) / thread_count;
+
+    // constructed[t] is the number of elements of chunk t which were constructed
+    std::vector<std::size_t> constructed(thread_count, 0);
+    std::vector<std::exception_ptr> errors(thread_count);
+    std::vector<std::thread> threads;
+
+    auto process_chunk = [&](std::size_t t) {
+        std::size_t begin = t * chunk_size;
+        std::size_t end = std::min(size, begin + chunk_size);
+        try {
+            map_range(arr + begin, result.data + begin, end - begin, func, constructed[t]);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    auto join_all = [&] {
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    };
+
+    auto destroy_constructed = [&] {
+        for (std::size_t t = 0; t < thread_count; ++t) {
+            std::destroy_n(result.data + t * chunk_size, constructed[t]);
+        }
+    };
+
+    // The calling thread processes the first chunk itself
+    for (std::size_t t = 1; t < thread_count; ++t) {
+        try {
+            threads.emplace_back(process_chunk, t);
+        } catch (const std::system_error&) {
+            process_chunk(t); // no more threads available, do it here
+        } catch (...) {
+            // Destroying a thread which was not joined calls std::terminate,
+            // so the started threads must finish before the error is passed on
+            join_all();
+            destroy_constructed();
+            throw;
+        }
+    }
+    process_chunk(0);
+    join_all();
+
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        if (errors[t]) {
+            destroy_constructed();
+            std::rethrow_exception(errors[t]);
+        }
+    }
+
+    result.size = size;
     return result;
 }
 
@@ -31,23 +184,29 @@ bool applyOperation(bool (*op)(int, int),
 int main() {
     int arr[] = {1, 2, 3, 4, 5};
 
-    int size = sizeof(arr) / sizeof(arr[0]);
-    // map(arr, 5, &addOne);
+    std::size_t size = sizeof(arr) / sizeof(arr[0]);
 
-    // for (size_t i = 0; i < size; i++)
-    // {
-    //     std::cout << arr[i] << " ";
-    // }
-    
-    string* result = map<string, int>(arr, size, &toString);
+    MappedArray<string> result = map(arr, size, &toString);
 
-    for (size_t i = 0; i < size; i++)
+    for (const string& s : result)
     {
-        std::cout << result[i] << " ";
+        std::cout << s << " ";
     }
+    std::cout << std::endl;
 
-    delete[] result;
+    // Any callable can be used, and large inputs are processed in parallel
+    std::vector<int> numbers(1'000'000);
+    for (std::size_t i = 0; i < numbers.size(); ++i) {
+        numbers[i] = static_cast<int>(i);
+    }
+
+    int offset = 10;
+    MappedArray<long long> squares = map(numbers.data(), numbers.size(), [offset](int x) {
+        return static_cast<long long>(x) * x + offset;
+    });
+
+    std::cout << "squares[999999] = " << squares[999'999] << std::endl;
 
     std::cout << "Hello, World!" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -1,5 +1,8 @@
 #include <iostream>
 #include <string>
+#include <vector>
+
+#include "pipeline.hpp"
 
 using std::cout;
 using std::endl;
@@ -33,44 +36,6 @@ private:
     T* _current;
 };
 
-template <class T>
-class Container;
-
-template <typename T>
-class MapIterator {
-public:
-    static MapIterator<T> mend(Container<T>* cont, T (*func)(const T)) {
-        MapIterator<T> it(cont, func);
-        it._current = cont->_data + cont->_size;
-        return it;
-    }
-
-    MapIterator(Container<T>* cont, T (*func)(T)) {
-        this->func = func;
-        _current = cont->_data;
-        _end = cont->_data + cont->_size;
-    }
-
-    MapIterator<T>& operator++() {
-        ++_current;
-        return *this;
-    }
-
-    T operator*() const{
-        return func(*_current);
-    }
-
-    bool operator!=(const MapIterator& other) const {
-        return _current != other._current;
-    }
-
-private:
-    T (*func)(T);
-    T* _current;
-    T* _end;
-};
-
-
 template <typename T>
 class ReverseIterator {
 private:
@@ -101,7 +66,6 @@ private:
     int _size;
 
 public:
-    friend class MapIterator<T>;
     static const int DEFAULT_SIZE = 10;
 
     Container(int size=DEFAULT_SIZE) : _size(size) {
@@ -190,12 +154,50 @@ int main() {
         std::cout << (*it).data() << " ";
     }
 
-    cout << std::endl << "Map iterator:" << std::endl;
+    cout << std::endl << "Map:" << std::endl;
 
-    MapIterator<Data> begin(&container, &toSixthPower);
-    MapIterator<Data> end = MapIterator<Data>::mend(&container, &toSixthPower);
+    // The pipeline replaces the old MapIterator: it accepts any callable
+    // (not only a T (*)(T) pointer), the result may have a different type,
+    // and all stages are inlined into one loop over the container.
+    pipeline::from(container)
+        .map(toSixthPower)
+        .for_each([](const Data& d) { std::cout << d.data() << " "; });
 
-    for (MapIterator<Data> it = begin; it != end; ++it) {
-        std::cout << (*it).data() << " ";
-    }
-}
\ No newline at end of file
+    cout << std::endl << "Map to another type, filter and take:" << std::endl;
+
+    pipeline::from(container)
+        .map([](const Data& d) { return std::to_string(d.data()) + "!"; })
+        .filter([](const std::string& s) { return s != "0!"; })
+        .take(3)
+        .for_each([](const std::string& s) { std::cout << s << " "; });
+
+    cout << std::endl << "Enumerate:" << std::endl;
+
+    pipeline::from(container)
+        .enumerate()
+        .for_each([](const auto& pair) { std::cout << pair.first << ":" << pair.second.data() << " "; });
+
+    cout << std::endl << "Zip:" << std::endl;
+
+    std::vector<int> weights = {1, 2, 3, 4, 5};
+
+    int weighted_sum = pipeline::zip(container, weights)
+        .map([](const auto& pair) { return pair.first.data() * pair.second; })
+        .sum();
+
+    std::cout << weighted_sum;
+
+    cout << std::endl << "Chunk:" << std::endl;
+
+    pipeline::from(weights)
+        .chunk(2)
+        .for_each([](auto chunk) {
+            std::cout << "[ ";
+            for (int x : chunk) {
+                std::cout << x << " ";
+            }
+            std::cout << "] ";
+        });
+
+    std::cout << std::endl;
+}
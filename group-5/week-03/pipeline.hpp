@@ -0,0 +1,356 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Lazy pipelines over collections: map, filter, take, zip, enumerate, chunk.
+//
+//   int total = pipeline::from(numbers)
+//                   .filter([](int x) { return x % 2 == 0; })
+//                   .map([](int x) { return x * x; })
+//                   .take(100)
+//                   .sum();
+//
+// Nothing happens until a terminal operation (for_each, reduce, sum, count,
+// to_vector) is called. Then the source runs one loop over its elements and
+// pushes every element through all the stages.
+//
+// Unlike MapIterator, which calls its function through a pointer, every
+// stage stores its callable (lambda, functor or function) by value and its
+// type is part of the pipeline's type. The compiler sees the whole chain
+// and can inline it into a single loop, which it is then free to vectorize.
+//
+// A source is any collection with data() and size() (contiguous, e.g. the
+// dsa arrays and std::vector) or with begin() and end() (e.g. Container<T>).
+// It is taken by reference, so it must outlive the pipeline.
+
+namespace pipeline {
+
+// ---- Sinks ----
+//
+// A sink receives the elements through push(), which returns false when it
+// does not want any more elements. finish() is called once at the end.
+// Each stage is a sink which passes (some of) its elements to the next one.
+
+template <typename F>
+struct ForEachSink {
+    F func;
+
+    template <typename V>
+    bool push(V&& value) {
+        func(std::forward<V>(value));
+        return true;
+    }
+
+    void finish() {}
+};
+
+template <typename F, typename Next>
+struct MapSink {
+    F func;
+    Next next;
+
+    template <typename V>
+    bool push(V&& value) {
+        return next.push(func(std::forward<V>(value)));
+    }
+
+    void finish() {
+        next.finish();
+    }
+};
+
+template <typename Predicate, typename Next>
+struct FilterSink {
+    Predicate predicate;
+    Next next;
+
+    template <typename V>
+    bool push(V&& value) {
+        if (!predicate(value)) {
+            return true;
+        }
+        return next.push(std::forward<V>(value));
+    }
+
+    void finish() {
+        next.finish();
+    }
+};
+
+template <typename Next>
+struct TakeSink {
+    std::size_t remaining;
+    Next next;
+
+    template <typename V>
+    bool push(V&& value) {
+        if (remaining == 0) {
+            return false;
+        }
+        --remaining;
+        return next.push(std::forward<V>(value)) && remaining > 0;
+    }
+
+    void finish() {
+        next.finish();
+    }
+};
+
+template <typename Value, typename Next>
+struct EnumerateSink {
+    std::size_t index;
+    Next next;
+
+    template <typename V>
+    bool push(V&& value) {
+        return next.push(std::pair<std::size_t, Value>(index++, std::forward<V>(value)));
+    }
+
+    void finish() {
+        next.finish();
+    }
+};
+
+// Collects the elements into groups of `size` and passes each group on as a
+// std::span, which is valid only during the call. The last group may be shorter.
+template <typename Element, typename Next>
+struct ChunkSink {
+    std::size_t size;
+    Next next;
+    std::vector<Element> buffer;
+    bool stopped = false;
+
+    template <typename V>
+    bool push(V&& value) {
+        buffer.push_back(std::forward<V>(value));
+        if (buffer.size() < size) {
+            return true;
+        }
+        return flush();
+    }
+
+    void finish() {
+        if (!stopped && !buffer.empty()) {
+            flush();
+        }
+        next.finish();
+    }
+
+private:
+    bool flush() {
+        stopped = !next.push(std::span<const Element>(buffer.data(), buffer.size()));
+        buffer.clear();
+        return !stopped;
+    }
+};
+
+// ---- Sources ----
+
+template <typename Range>
+concept Contiguous = requires(Range& range) {
+    range.data();
+    range.size();
+};
+
+// A contiguous collection is walked with plain pointers, which is the
+// easiest loop for the compiler to vectorize
+template <typename Range>
+auto first_of(Range& range) {
+    if constexpr (Contiguous<Range>) {
+        return range.data();
+    } else {
+        return range.begin();
+    }
+}
+
+template <typename Range>
+auto last_of(Range& range) {
+    if constexpr (Contiguous<Range>) {
+        return range.data() + range.size();
+    } else {
+        return range.end();
+    }
+}
+
+template <typename Range>
+using reference_of = decltype(*first_of(std::declval<Range&>()));
+
+template <typename Range>
+struct RangeSource {
+    Range* range;
+
+    template <typename Sink>
+    void run(Sink& sink) const {
+        auto end = last_of(*range);
+        for (auto it = first_of(*range); it != end; ++it) {
+            if (!sink.push(*it)) {
+                return;
+            }
+        }
+    }
+};
+
+// Walks two collections side by side and stops at the end of the shorter one
+template <typename Left, typename Right>
+struct ZipSource {
+    Left* left;
+    Right* right;
+
+    template <typename Sink>
+    void run(Sink& sink) const {
+        using Pair = std::pair<reference_of<Left>, reference_of<Right>>;
+
+        auto left_end = last_of(*left);
+        auto right_end = last_of(*right);
+        auto right_it = first_of(*right);
+
+        for (auto left_it = first_of(*left); left_it != left_end && right_it != right_end; ++left_it, ++right_it) {
+            if (!sink.push(Pair(*left_it, *right_it))) {
+                return;
+            }
+        }
+    }
+};
+
+struct NoStages {
+    template <typename Sink>
+    Sink operator()(Sink sink) const {
+        return sink;
+    }
+};
+
+// ---- Pipeline ----
+//
+// Value is the type of the elements which come out of the last stage.
+// Stages is a callable which wraps the final sink in the sinks of all
+// stages, starting from the last one.
+template <typename Source, typename Value, typename Stages = NoStages>
+class Pipeline {
+public:
+    using value_type = Value;
+
+    Pipeline(Source source, Stages stages = Stages()) : _source(source), _stages(stages) {}
+
+    // Replaces every element x with func(x)
+    template <typename F>
+    auto map(F func) const {
+        using Result = std::invoke_result_t<F&, Value>;
+
+        return then<Result>([func](auto next) {
+            return MapSink<F, decltype(next)>{func, std::move(next)};
+        });
+    }
+
+    // Keeps only the elements for which predicate(x) is true
+    template <typename Predicate>
+    auto filter(Predicate predicate) const {
+        return then<Value>([predicate](auto next) {
+            return FilterSink<Predicate, decltype(next)>{predicate, std::move(next)};
+        });
+    }
+
+    // Keeps only the first `count` elements; the source stops after them
+    auto take(std::size_t count) const {
+        return then<Value>([count](auto next) {
+            return TakeSink<decltype(next)>{count, std::move(next)};
+        });
+    }
+
+    // Replaces every element x with the pair (index, x)
+    auto enumerate() const {
+        using Pair = std::pair<std::size_t, Value>;
+
+        return then<Pair>([](auto next) {
+            return EnumerateSink<Value, decltype(next)>{0, std::move(next)};
+        });
+    }
+
+    // Groups the elements into std::span<const T> of `size` elements (the last
+    // one may be shorter). The spans are valid only until the next group is made.
+    auto chunk(std::size_t size) const {
+        using Element = std::remove_cvref_t<Value>;
+
+        return then<std::span<const Element>>([size](auto next) {
+            ChunkSink<Element, decltype(next)> sink{size > 0 ? size : 1, std::move(next), {}};
+            sink.buffer.reserve(sink.size);
+            return sink;
+        });
+    }
+
+    // ---- Terminal operations ----
+
+    // Calls func(x) for every element
+    template <typename F>
+    void for_each(F func) const {
+        run(ForEachSink<F>{func});
+    }
+
+    // Combines all elements: op(...op(op(init, x1), x2)..., xn)
+    template <typename T, typename Operation>
+    T reduce(T init, Operation op) const {
+        for_each([&init, &op](auto&& value) {
+            init = op(std::move(init), std::forward<decltype(value)>(value));
+        });
+        return init;
+    }
+
+    auto sum() const {
+        return reduce(std::remove_cvref_t<Value>(), std::plus<>());
+    }
+
+    std::size_t count() const {
+        std::size_t result = 0;
+        for_each([&result](auto&&) { ++result; });
+        return result;
+    }
+
+    // Copies the elements into a vector. Not meant for chunk(),
+    // whose spans do not outlive the loop.
+    std::vector<std::remove_cvref_t<Value>> to_vector() const {
+        std::vector<std::remove_cvref_t<Value>> result;
+        for_each([&result](auto&& value) {
+            result.push_back(std::forward<decltype(value)>(value));
+        });
+        return result;
+    }
+
+private:
+    Source _source;
+    Stages _stages;
+
+    // A pipeline with `stage` added after the existing stages
+    template <typename NewValue, typename Stage>
+    auto then(Stage stage) const {
+        auto stages = [previous = _stages, stage](auto sink) {
+            return previous(stage(std::move(sink)));
+        };
+        return Pipeline<Source, NewValue, decltype(stages)>(_source, stages);
+    }
+
+    template <typename Sink>
+    void run(Sink sink) const {
+        auto first = _stages(std::move(sink));
+        _source.run(first);
+        first.finish();
+    }
+};
+
+// Starts a pipeline over the elements of range
+template <typename Range>
+auto from(Range& range) {
+    return Pipeline<RangeSource<Range>, reference_of<Range>>(RangeSource<Range>{&range});
+}
+
+// Starts a pipeline over pairs (left[i], right[i]), as long as the shorter range
+template <typename Left, typename Right>
+auto zip(Left& left, Right& right) {
+    using Pair = std::pair<reference_of<Left>, reference_of<Right>>;
+    return Pipeline<ZipSource<Left, Right>, Pair>(ZipSource<Left, Right>{&left, &right});
+}
+
+} // namespace pipeline
@@ -3,6 +3,8 @@
 #include <vector>
 #include <iostream>
 #include <cstdint>
+#include <iterator>
+#include <stdexcept>
 
 class BitSet{
 private:
@@ -21,6 +23,38 @@ public:
         values.reserve((size / 8) + 1);
     }
 
+    // Creates a set from `size` bits packed in `bytes`, least significant bit first.
+    // The bytes are copied as a block, so this runs at memcpy speed.
+    BitSet(const uint8_t* bytes, size_t size)
+        : values(bytes, bytes + (size + 7) / 8), bit_size(size)
+    {
+        clear_unused_bits();
+    }
+
+    // Creates a set from a range of bools
+    template <std::input_iterator InputIt>
+    BitSet(InputIt first, InputIt last) : bit_size(0)
+    {
+        if constexpr (std::forward_iterator<InputIt>) {
+            values.reserve((std::distance(first, last) + 7) / 8);
+        }
+
+        // Collect 64 bits in a word and append them together
+        uint64_t word = 0;
+        unsigned count = 0;
+
+        for (; first != last; ++first) {
+            word |= uint64_t(bool(*first)) << count;
+            if (++count == 64) {
+                append_bits(word, count);
+                word = 0;
+                count = 0;
+            }
+        }
+
+        append_bits(word, count);
+    }
+
     class BitProxy 
     {
         private:
@@ -59,7 +93,7 @@ public:
             throw std::out_of_range("BitSet index out of range");
         }
 
-        this->getElement(index);
+        return this->getElement(index);
     }
 
     void push_back(bool value) 
@@ -72,10 +106,68 @@ public:
         bit_size++;
     }
 
+    // Appends the lowest n bits of word (n <= 64), least significant bit first
+    void append_bits(uint64_t word, unsigned n)
+    {
+        if (n > 64) {
+            throw std::invalid_argument("BitSet::append_bits can append at most 64 bits");
+        }
+        if (n == 0) {
+            return;
+        }
+        if (n < 64) {
+            word &= (uint64_t(1) << n) - 1;
+        }
+
+        size_t offset = bit_size % 8;
+        size_t index = byte_index(bit_size);
+        size_t new_size = bit_size + n;
+        values.resize((new_size + 7) / 8, 0);
+
+        // Fill the free bits of the last partially used byte
+        if (offset != 0) {
+            values[index++] |= uint8_t(word << offset);
+            word >>= 8 - offset;
+        }
+
+        // The rest goes in whole bytes
+        for (; index < values.size(); ++index) {
+            values[index] = uint8_t(word);
+            word >>= 8;
+        }
+
+        bit_size = new_size;
+    }
+
+    // Changes the number of bits. New bits are set to value.
+    void resize(size_t size, bool value = false)
+    {
+        if (size > bit_size) {
+            size_t offset = bit_size % 8;
+
+            if (offset != 0 && value) {
+                values.back() |= uint8_t(0xFF << offset);
+            }
+
+            // Whole new bytes are filled at once
+            values.resize((size + 7) / 8, value ? 0xFF : 0);
+        } else {
+            values.resize((size + 7) / 8);
+        }
+
+        bit_size = size;
+        clear_unused_bits();
+    }
+
     void pop_back();
     size_t size() const {
         return bit_size;
     }
+
+    // The packed bits, least significant bit of each byte first
+    const uint8_t* data() const {
+        return values.data();
+    }
     void flip();
     void flip(size_t pos);
     bool all()const;
@@ -83,6 +175,16 @@ public:
     bool none()const;
 
 private:
+    // Bits past the end of the last byte are kept at zero,
+    // so whole bytes can be compared and combined
+    void clear_unused_bits()
+    {
+        size_t offset = bit_size % 8;
+        if (offset != 0) {
+            values.back() &= uint8_t((1 << offset) - 1);
+        }
+    }
+
     BitProxy getElement(size_t index)
     {   
         // std::cout << "Getting element at index: " << index << std::endl;
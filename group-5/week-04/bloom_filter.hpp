@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Computes where a key goes in a blocked Bloom filter.
+//
+// The bits are split into blocks of 512 bits (one 64-byte cache line) and
+// all probes of a key land in the same block, so a lookup touches one line
+// instead of k random ones. The k bit offsets inside the block are computed
+// up front into a small array, so the loop which tests them has no branch
+// per probe and no dependency between the probes.
+class BloomLayout {
+public:
+    static constexpr size_t block_bits = 512;
+    static constexpr unsigned max_hashes = 16;
+
+    BloomLayout(size_t bit_count, unsigned hash_count)
+        : block_count((bit_count + block_bits - 1) / block_bits), hash_count(hash_count)
+    {
+        if (block_count == 0) {
+            block_count = 1;
+        }
+        if (hash_count == 0 || hash_count > max_hashes) {
+            throw std::invalid_argument("Bloom filter hash count must be in [1, 16]");
+        }
+    }
+
+    // Number of bits needed to store `items` keys with the given false positive rate
+    static size_t optimal_bit_count(size_t items, double false_positive_rate)
+    {
+        if (false_positive_rate <= 0 || false_positive_rate >= 1) {
+            throw std::invalid_argument("False positive rate must be in (0, 1)");
+        }
+
+        const double ln2 = std::log(2.0);
+        double bits = -static_cast<double>(items) * std::log(false_positive_rate) / (ln2 * ln2);
+        return static_cast<size_t>(std::ceil(bits));
+    }
+
+    // Number of hash functions which minimizes the false positive rate
+    static unsigned optimal_hash_count(size_t bit_count, size_t items)
+    {
+        if (items == 0) {
+            return 1;
+        }
+
+        double k = std::round(static_cast<double>(bit_count) / items * std::log(2.0));
+        if (k < 1) {
+            return 1;
+        }
+        return k > max_hashes ? max_hashes : static_cast<unsigned>(k);
+    }
+
+    size_t bit_count() const {
+        return block_count * block_bits;
+    }
+
+    unsigned hashes() const {
+        return hash_count;
+    }
+
+    bool operator==(const BloomLayout& other) const {
+        return block_count == other.block_count && hash_count == other.hash_count;
+    }
+
+    size_t blocks() const {
+        return block_count;
+    }
+
+    // Returns the block of a key with hash `h` and writes the `hashes()`
+    // offsets of its bits inside the block (0 to 511) into `offsets`
+    size_t probes(uint64_t h, uint32_t (&offsets)[max_hashes]) const
+    {
+        // std::hash is the identity for integers on most implementations,
+        // so the value is mixed before it is used.
+        h = mix(h);
+
+        // Double hashing inside the block: h1 + i*h2.
+        // h2 is odd, so the probes cycle through all 512 positions.
+        uint64_t g = mix(h ^ 0x9e3779b97f4a7c15ULL);
+        uint32_t h1 = static_cast<uint32_t>(g);
+        uint32_t h2 = static_cast<uint32_t>(g >> 32) | 1;
+
+        for (unsigned i = 0; i < hash_count; ++i) {
+            offsets[i] = (h1 + i * h2) % block_bits;
+        }
+
+        return h % block_count;
+    }
+
+private:
+    size_t block_count;
+    unsigned hash_count;
+
+    // Finalizer of SplitMix64
+    static uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+};
+
+// Blocked Bloom filter.
+//
+// possibly_contains() never returns false for an inserted key, but may
+// return true for a key that was never inserted.
+//
+// Each block is 8 words aligned to a cache line, so a key's probes never
+// straddle two lines. The probes set and test bits directly with a word
+// index and a mask; the offsets from BloomLayout are always in range, so
+// there is no bounds check per probe.
+template <typename T, typename Hash = std::hash<T>>
+class BloomFilter {
+private:
+    struct alignas(64) Block {
+        uint64_t words[BloomLayout::block_bits / 64] = {};
+    };
+
+    BloomLayout layout;
+    std::vector<Block> blocks; // over-aligned, so allocated with aligned new
+    Hash hasher;
+
+public:
+    BloomFilter(size_t bit_count, unsigned hash_count, const Hash& hasher = Hash())
+        : layout(bit_count, hash_count), blocks(layout.blocks()), hasher(hasher)
+    {}
+
+    // Creates a filter big enough for `items` keys at the desired false positive rate.
+    // Keeping all probes in one block makes the real rate somewhat higher than
+    // the textbook formula predicts, noticeably so for targets below 1%.
+    static BloomFilter for_capacity(size_t items, double false_positive_rate)
+    {
+        size_t bit_count = BloomLayout::optimal_bit_count(items, false_positive_rate);
+        return BloomFilter(bit_count, BloomLayout::optimal_hash_count(bit_count, items));
+    }
+
+    void insert(const T& key)
+    {
+        uint32_t offsets[BloomLayout::max_hashes];
+        Block& block = blocks[layout.probes(hasher(key), offsets)];
+
+        for (unsigned i = 0; i < layout.hashes(); ++i) {
+            block.words[offsets[i] / 64] |= uint64_t(1) << (offsets[i] % 64);
+        }
+    }
+
+    bool possibly_contains(const T& key) const
+    {
+        uint32_t offsets[BloomLayout::max_hashes];
+        const Block& block = blocks[layout.probes(hasher(key), offsets)];
+
+        uint64_t found = 1;
+        for (unsigned i = 0; i < layout.hashes(); ++i) {
+            found &= block.words[offsets[i] / 64] >> (offsets[i] % 64);
+        }
+        return found & 1;
+    }
+
+    // The filter of the union of both key sets
+    BloomFilter& operator|=(const BloomFilter& other)
+    {
+        check_compatible(other);
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            for (size_t w = 0; w < std::size(blocks[b].words); ++w) {
+                blocks[b].words[w] |= other.blocks[b].words[w];
+            }
+        }
+        return *this;
+    }
+
+    // Approximates the filter of the intersection of both key sets.
+    // Its false positive rate is at least that of either operand.
+    BloomFilter& operator&=(const BloomFilter& other)
+    {
+        check_compatible(other);
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            for (size_t w = 0; w < std::size(blocks[b].words); ++w) {
+                blocks[b].words[w] &= other.blocks[b].words[w];
+            }
+        }
+        return *this;
+    }
+
+    size_t bit_count() const {
+        return layout.bit_count();
+    }
+
+    unsigned hash_count() const {
+        return layout.hashes();
+    }
+
+private:
+    void check_compatible(const BloomFilter& other) const
+    {
+        if (!(layout == other.layout)) {
+            throw std::invalid_argument("Bloom filters have different sizes or hash counts");
+        }
+    }
+};
+
+// Bloom filter with a small counter instead of a single bit per position,
+// which makes it possible to remove keys.
+//
+// Counters saturate at 255 and are never decremented after that, so an
+// overflow can only cause false positives, never false negatives.
+// Removing a key that was never inserted corrupts the filter.
+template <typename T, typename Hash = std::hash<T>>
+class CountingBloomFilter {
+private:
+    static constexpr uint8_t saturated = std::numeric_limits<uint8_t>::max();
+
+    BloomLayout layout;
+    std::vector<uint8_t> counters;
+    Hash hasher;
+
+public:
+    CountingBloomFilter(size_t bit_count, unsigned hash_count, const Hash& hasher = Hash())
+        : layout(bit_count, hash_count), counters(layout.bit_count(), 0), hasher(hasher)
+    {}
+
+    static CountingBloomFilter for_capacity(size_t items, double false_positive_rate)
+    {
+        size_t bit_count = BloomLayout::optimal_bit_count(items, false_positive_rate);
+        return CountingBloomFilter(bit_count, BloomLayout::optimal_hash_count(bit_count, items));
+    }
+
+    void insert(const T& key)
+    {
+        uint32_t offsets[BloomLayout::max_hashes];
+        uint8_t* block = &counters[layout.probes(hasher(key), offsets) * BloomLayout::block_bits];
+
+        for (unsigned i = 0; i < layout.hashes(); ++i) {
+            uint8_t& counter = block[offsets[i]];
+            if (counter != saturated) {
+                ++counter;
+            }
+        }
+    }
+
+    // Removes a key. Returns false (and changes nothing) if the key is surely not in the filter.
+    bool remove(const T& key)
+    {
+        uint32_t offsets[BloomLayout::max_hashes];
+        uint8_t* block = &counters[layout.probes(hasher(key), offsets) * BloomLayout::block_bits];
+
+        for (unsigned i = 0; i < layout.hashes(); ++i) {
+            if (block[offsets[i]] == 0) {
+                return false;
+            }
+        }
+
+        for (unsigned i = 0; i < layout.hashes(); ++i) {
+            uint8_t& counter = block[offsets[i]];
+            if (counter != saturated) {
+                --counter;
+            }
+        }
+        return true;
+    }
+
+    bool possibly_contains(const T& key) const
+    {
+        uint32_t offsets[BloomLayout::max_hashes];
+        const uint8_t* block = &counters[layout.probes(hasher(key), offsets) * BloomLayout::block_bits];
+
+        bool found = true;
+        for (unsigned i = 0; i < layout.hashes(); ++i) {
+            found &= block[offsets[i]] != 0;
+        }
+        return found;
+    }
+
+    size_t bit_count() const {
+        return layout.bit_count();
+    }
+
+    unsigned hash_count() const {
+        return layout.hashes();
+    }
+};
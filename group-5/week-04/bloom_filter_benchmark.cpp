@@ -0,0 +1,73 @@
+// Measures the query throughput and the actual false positive rate
+// of the Bloom filters in bloom_filter.hpp.
+//
+// Build with optimizations, e.g.:
+//   g++ -std=c++20 -O2 bloom_filter_benchmark.cpp -o bloom_filter_benchmark
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "bloom_filter.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Filter>
+void benchmark(const char* name, Filter& filter, const std::vector<uint64_t>& inserted,
+               const std::vector<uint64_t>& absent)
+{
+    Clock::time_point start = Clock::now();
+    for (uint64_t key : inserted) {
+        filter.insert(key);
+    }
+    double insert_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Every inserted key must be found
+    size_t missing = 0;
+    for (uint64_t key : inserted) {
+        missing += !filter.possibly_contains(key);
+    }
+
+    start = Clock::now();
+    size_t false_positives = 0;
+    for (uint64_t key : absent) {
+        false_positives += filter.possibly_contains(key);
+    }
+    double query_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << name << " (" << filter.bit_count() << " bits, "
+              << filter.hash_count() << " hashes)\n"
+              << "    inserts/s:           " << inserted.size() / insert_seconds << "\n"
+              << "    queries/s:           " << absent.size() / query_seconds << "\n"
+              << "    false negatives:     " << missing << "\n"
+              << "    false positive rate: "
+              << static_cast<double>(false_positives) / absent.size() << "\n\n";
+}
+
+int main()
+{
+    const size_t items = 1'000'000;
+    const double rates[] = { 0.1, 0.01, 0.001 };
+
+    // Odd keys are inserted, even keys are queried, so no queried key is present
+    std::mt19937_64 generator(42);
+    std::vector<uint64_t> inserted(items), absent(items);
+    for (size_t i = 0; i < items; ++i) {
+        inserted[i] = generator() | 1;
+        absent[i] = generator() & ~uint64_t(1);
+    }
+
+    for (double rate : rates) {
+        std::cout << "Target false positive rate: " << rate << "\n\n";
+
+        BloomFilter<uint64_t> filter = BloomFilter<uint64_t>::for_capacity(items, rate);
+        benchmark("BloomFilter", filter, inserted, absent);
+
+        CountingBloomFilter<uint64_t> counting = CountingBloomFilter<uint64_t>::for_capacity(items, rate);
+        benchmark("CountingBloomFilter", counting, inserted, absent);
+    }
+
+    return 0;
+}
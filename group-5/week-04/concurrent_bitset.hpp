@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+// A BitSet that can be shared between threads without locks.
+//
+// BitSet::BitProxy::operator= is a plain read-modify-write of a whole byte,
+// so two threads writing neighbouring bits can lose each other's update.
+// Here every operation is a single atomic fetch_or / fetch_and / fetch_xor
+// on a 64-bit word, with the memory ordering chosen by the caller.
+//
+// The size is fixed at construction: growing the storage while other
+// threads are using it would need a lock anyway.
+class ConcurrentBitSet {
+private:
+    using word_type = uint64_t;
+    static constexpr size_t bits_per_word = 64;
+
+    std::unique_ptr<std::atomic<word_type>[]> words;
+    size_t bit_size;
+    size_t word_count;
+
+    static size_t word_index(size_t bit_index) {
+        return bit_index / bits_per_word;
+    }
+
+    static word_type mask(size_t bit_index) {
+        return word_type(1) << (bit_index % bits_per_word);
+    }
+
+    std::atomic<word_type>& word_of(size_t bit_index) {
+        if (bit_index >= bit_size) {
+            throw std::out_of_range("ConcurrentBitSet index out of range");
+        }
+        return words[word_index(bit_index)];
+    }
+
+    const std::atomic<word_type>& word_of(size_t bit_index) const {
+        if (bit_index >= bit_size) {
+            throw std::out_of_range("ConcurrentBitSet index out of range");
+        }
+        return words[word_index(bit_index)];
+    }
+
+public:
+    ConcurrentBitSet() : bit_size(0), word_count(0) {}
+
+    // Creates a set of `size` bits, all of them cleared
+    explicit ConcurrentBitSet(size_t size)
+        : words(new std::atomic<word_type>[(size + bits_per_word - 1) / bits_per_word]),
+          bit_size(size),
+          word_count((size + bits_per_word - 1) / bits_per_word)
+    {
+        for (size_t i = 0; i < word_count; ++i) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Atomics are not copyable and copying a set that other threads
+    // are modifying has no well-defined result anyway.
+    ConcurrentBitSet(const ConcurrentBitSet&) = delete;
+    ConcurrentBitSet& operator=(const ConcurrentBitSet&) = delete;
+
+    ConcurrentBitSet(ConcurrentBitSet&& other) noexcept
+        : words(std::move(other.words)), bit_size(other.bit_size), word_count(other.word_count)
+    {
+        other.bit_size = 0;
+        other.word_count = 0;
+    }
+
+    ConcurrentBitSet& operator=(ConcurrentBitSet&& other) noexcept {
+        words = std::move(other.words);
+        bit_size = other.bit_size;
+        word_count = other.word_count;
+        other.bit_size = 0;
+        other.word_count = 0;
+        return *this;
+    }
+
+    size_t size() const {
+        return bit_size;
+    }
+
+    bool test(size_t index, std::memory_order order = std::memory_order_seq_cst) const {
+        return (word_of(index).load(order) & mask(index)) != 0;
+    }
+
+    bool operator[](size_t index) const {
+        return test(index);
+    }
+
+    void set(size_t index, std::memory_order order = std::memory_order_seq_cst) {
+        word_of(index).fetch_or(mask(index), order);
+    }
+
+    void reset(size_t index, std::memory_order order = std::memory_order_seq_cst) {
+        word_of(index).fetch_and(~mask(index), order);
+    }
+
+    // Sets the bit and returns its previous value.
+    // Of several threads racing to set the same bit exactly one gets false,
+    // which is what marking items as "visited" needs.
+    bool test_and_set(size_t index, std::memory_order order = std::memory_order_seq_cst) {
+        word_type m = mask(index);
+        return (word_of(index).fetch_or(m, order) & m) != 0;
+    }
+
+    // Clears the bit and returns its previous value
+    bool test_and_reset(size_t index, std::memory_order order = std::memory_order_seq_cst) {
+        word_type m = mask(index);
+        return (word_of(index).fetch_and(~m, order) & m) != 0;
+    }
+
+    // Flips the bit and returns its previous value
+    bool flip(size_t index, std::memory_order order = std::memory_order_seq_cst) {
+        word_type m = mask(index);
+        return (word_of(index).fetch_xor(m, order) & m) != 0;
+    }
+
+    // Number of set bits. The words are not read as one snapshot,
+    // so the result is approximate while other threads are writing.
+    size_t count(std::memory_order order = std::memory_order_seq_cst) const {
+        size_t result = 0;
+        for (size_t i = 0; i < word_count; ++i) {
+            result += std::popcount(words[i].load(order));
+        }
+        return result;
+    }
+
+    // Clears all bits. Atomic per word, not for the set as a whole.
+    void clear(std::memory_order order = std::memory_order_seq_cst) {
+        for (size_t i = 0; i < word_count; ++i) {
+            words[i].store(0, order);
+        }
+    }
+};
@@ -1,5 +1,8 @@
 #include <iostream>
+#include <thread>
+#include <vector>
 #include "bitset.hpp"
+#include "concurrent_bitset.hpp"
 
 int main() {
     BitSet bits(10);
@@ -17,5 +20,35 @@ int main() {
     std::cout << "BitSet's 4th element: " << bits[3] << std::endl;
     std::cout << "BitSet's 5th element: " << bits[4] << std::endl;
 
+    // Several threads mark items as visited in one shared bitmap.
+    // Each item is claimed by exactly one thread.
+    const size_t items = 100000;
+    const unsigned threads_count = 4;
+    ConcurrentBitSet visited(items);
+    std::vector<size_t> claimed(threads_count, 0);
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads_count; ++t) {
+        workers.emplace_back([&visited, &claimed, t]() {
+            for (size_t i = 0; i < items; ++i) {
+                if (!visited.test_and_set(i, std::memory_order_relaxed)) {
+                    ++claimed[t];
+                }
+            }
+        });
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    size_t total = 0;
+    for (size_t c : claimed) {
+        total += c;
+    }
+
+    std::cout << "Visited items: " << visited.count()
+              << ", claimed by the threads: " << total << std::endl;
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bitset.hpp"
+
+// A bit set stored in a file and mapped in memory with mmap (POSIX only).
+//
+// Opening the file costs the same no matter how big the bitmap is: nothing
+// is read up front and the OS loads pages on first access. In ReadWrite mode
+// the mapping is shared, so changes go to the file; flush() forces them out
+// with msync. The bits use the same layout as BitSet (least significant bit
+// of each byte first).
+//
+// File layout: 8 byte signature, 8 byte bit count, the packed bits.
+class MappedBitSet {
+public:
+    enum class Mode { ReadOnly, ReadWrite };
+
+private:
+    static constexpr char signature[8] = { 'B', 'I', 'T', 'S', 'E', 'T', '0', '1' };
+    static constexpr size_t header_size = 16;
+
+    int fd;
+    Mode mode;
+    uint8_t* mapping;
+    size_t mapping_size;
+    size_t bit_size;
+
+    // Does not round `bits` up first, so that a huge bit count read from a
+    // corrupt header cannot wrap around and pass the check against the file size
+    static uint64_t file_size_for(uint64_t bits) {
+        return header_size + bits / 8 + (bits % 8 != 0);
+    }
+
+    static void fail(const char* operation) {
+        throw std::system_error(errno, std::generic_category(), operation);
+    }
+
+    uint8_t* bytes() const {
+        return mapping + header_size;
+    }
+
+    void check_index(size_t index) const {
+        if (index >= bit_size) {
+            throw std::out_of_range("MappedBitSet index out of range");
+        }
+    }
+
+    void check_writable() const {
+        if (mode != Mode::ReadWrite) {
+            throw std::logic_error("MappedBitSet is opened read-only");
+        }
+    }
+
+    // Maps the first `size` bytes of the file; the current mapping is not touched
+    uint8_t* map_file(size_t size) const {
+        int protection = mode == Mode::ReadWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* address = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            fail("mmap");
+        }
+        return static_cast<uint8_t*>(address);
+    }
+
+    void map(size_t size) {
+        mapping = map_file(size);
+        mapping_size = size;
+    }
+
+    void unmap() {
+        if (mapping) {
+            munmap(mapping, mapping_size);
+            mapping = nullptr;
+            mapping_size = 0;
+        }
+    }
+
+    void write_size(size_t bits) {
+        uint64_t value = bits;
+        std::memcpy(mapping + sizeof(signature), &value, sizeof(value));
+    }
+
+    void close_file() {
+        unmap();
+        if (fd != -1) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    // With truncate the file is emptied first, so it gets a new header whatever it contained
+    MappedBitSet(const std::string& path, Mode mode, bool truncate)
+        : fd(-1), mode(mode), mapping(nullptr), mapping_size(0), bit_size(0)
+    {
+        int flags = mode == Mode::ReadWrite ? O_RDWR | O_CREAT : O_RDONLY;
+        if (truncate) {
+            flags |= O_TRUNC;
+        }
+
+        fd = ::open(path.c_str(), flags, 0644);
+        if (fd == -1) {
+            fail("open");
+        }
+
+        try {
+            struct stat info;
+            if (fstat(fd, &info) == -1) {
+                fail("fstat");
+            }
+
+            size_t size = static_cast<size_t>(info.st_size);
+
+            if (size == 0 && mode == Mode::ReadWrite) {
+                // A new file - write an empty header
+                if (ftruncate(fd, header_size) == -1) {
+                    fail("ftruncate");
+                }
+                map(header_size);
+                std::memcpy(mapping, signature, sizeof(signature));
+                write_size(0);
+                return;
+            }
+
+            if (size < header_size) {
+                throw std::runtime_error("Not a MappedBitSet file: " + path);
+            }
+
+            map(size);
+
+            uint64_t bits;
+            std::memcpy(&bits, mapping + sizeof(signature), sizeof(bits));
+
+            if (std::memcmp(mapping, signature, sizeof(signature)) != 0 || file_size_for(bits) > size) {
+                throw std::runtime_error("Not a MappedBitSet file: " + path);
+            }
+
+            bit_size = bits;
+        }
+        catch (...) {
+            close_file();
+            throw;
+        }
+    }
+
+public:
+    // Opens a bitmap file. In ReadWrite mode a missing file is created empty.
+    explicit MappedBitSet(const std::string& path, Mode mode = Mode::ReadOnly)
+        : MappedBitSet(path, mode, false)
+    {}
+
+    // Creates (or overwrites) a bitmap file with the contents of a BitSet.
+    // An existing file is replaced even if it is not a bitmap file.
+    static MappedBitSet create(const std::string& path, const BitSet& bits)
+    {
+        MappedBitSet result(path, Mode::ReadWrite, true);
+        result.resize(bits.size());
+        std::memcpy(result.bytes(), bits.data(), (bits.size() + 7) / 8);
+        return result;
+    }
+
+    MappedBitSet(const MappedBitSet&) = delete;
+    MappedBitSet& operator=(const MappedBitSet&) = delete;
+
+    MappedBitSet(MappedBitSet&& other) noexcept
+        : fd(other.fd), mode(other.mode), mapping(other.mapping),
+          mapping_size(other.mapping_size), bit_size(other.bit_size)
+    {
+        other.fd = -1;
+        other.mapping = nullptr;
+        other.mapping_size = 0;
+        other.bit_size = 0;
+    }
+
+    MappedBitSet& operator=(MappedBitSet&& other) noexcept {
+        if (this != &other) {
+            close_file();
+            std::swap(fd, other.fd);
+            std::swap(mode, other.mode);
+            std::swap(mapping, other.mapping);
+            std::swap(mapping_size, other.mapping_size);
+            std::swap(bit_size, other.bit_size);
+        }
+        return *this;
+    }
+
+    // Unmapping a shared mapping does not lose changes,
+    // the OS writes them back eventually even without flush()
+    ~MappedBitSet() {
+        close_file();
+    }
+
+    size_t size() const {
+        return bit_size;
+    }
+
+    bool test(size_t index) const {
+        check_index(index);
+        return (bytes()[index / 8] >> (index % 8)) & 1;
+    }
+
+    bool operator[](size_t index) const {
+        return test(index);
+    }
+
+    void set(size_t index, bool value = true) {
+        check_writable();
+        check_index(index);
+
+        uint8_t mask = uint8_t(1 << (index % 8));
+        if (value) {
+            bytes()[index / 8] |= mask;
+        } else {
+            bytes()[index / 8] &= ~mask;
+        }
+    }
+
+    // Changes the number of bits by resizing the file. New bits are zero.
+    // If the file cannot be resized or mapped, the set is left as it was.
+    void resize(size_t size) {
+        check_writable();
+
+        size_t old_file_size = mapping_size;
+        size_t new_file_size = file_size_for(size);
+        uint8_t* new_mapping;
+
+        // The new mapping is made while the old one still exists, and the file
+        // is only cut after the shorter mapping succeeded, so a failure in
+        // either step can be undone without losing any bits
+        if (new_file_size >= old_file_size) {
+            if (ftruncate(fd, new_file_size) == -1) {
+                fail("ftruncate");
+            }
+
+            try {
+                new_mapping = map_file(new_file_size);
+            }
+            catch (...) {
+                // Best effort: the extra bytes are zero and unused either way
+                [[maybe_unused]] int restored = ftruncate(fd, old_file_size);
+                throw;
+            }
+        } else {
+            new_mapping = map_file(new_file_size);
+
+            if (ftruncate(fd, new_file_size) == -1) {
+                int error = errno;
+                munmap(new_mapping, new_file_size);
+                errno = error;
+                fail("ftruncate");
+            }
+        }
+
+        unmap();
+        mapping = new_mapping;
+        mapping_size = new_file_size;
+
+        if (size < bit_size && size % 8 != 0) {
+            // Keep the bits past the end at zero, in case the set grows again
+            bytes()[size / 8] &= uint8_t((1 << (size % 8)) - 1);
+        }
+
+        write_size(size);
+        bit_size = size;
+    }
+
+    // Writes all changes to the file. With wait = false the writes are only scheduled.
+    void flush(bool wait = true) {
+        if (mode == Mode::ReadWrite && msync(mapping, mapping_size, wait ? MS_SYNC : MS_ASYNC) == -1) {
+            fail("msync");
+        }
+    }
+
+    // Hints the OS to start loading the pages holding bits [first, last)
+    void prefetch(size_t first, size_t last) const {
+        if (first >= last || last > bit_size) {
+            return;
+        }
+
+        long page = sysconf(_SC_PAGESIZE);
+        size_t begin = header_size + first / 8;
+        size_t end = header_size + (last + 7) / 8;
+        begin -= begin % page;
+
+        madvise(mapping + begin, end - begin, MADV_WILLNEED);
+    }
+
+    // Copies the bits into an in-memory BitSet
+    BitSet to_bitset() const {
+        return BitSet(bytes(), bit_size);
+    }
+};
@@ -0,0 +1,139 @@
+// Checks of MappedBitSet that need real files (POSIX only).
+//
+// Build and run, e.g.:
+//   g++ -std=c++20 -O2 mapped_bitset_test.cpp -o mapped_bitset_test && ./mapped_bitset_test
+
+#undef NDEBUG
+
+#include <cassert>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <sys/resource.h>
+
+#include "mapped_bitset.hpp"
+
+static void write_file(const std::string& path, const std::string& contents)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+}
+
+// Returns the errno of the std::system_error thrown by resize(), or 0
+static int resize_error(MappedBitSet& bits, size_t size)
+{
+    try {
+        bits.resize(size);
+    }
+    catch (const std::system_error& e) {
+        return e.code().value();
+    }
+    return 0;
+}
+
+static void check_pattern(const MappedBitSet& bits, size_t size)
+{
+    assert(bits.size() == size);
+    for (size_t i = 0; i < size; ++i) {
+        assert(bits[i] == (i % 3 == 0));
+    }
+}
+
+static bool rejects(const std::string& path)
+{
+    try {
+        MappedBitSet bits(path);
+    }
+    catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    const std::string path = "mapped_bitset_test.bin";
+
+    BitSet source;
+    for (size_t i = 0; i < 100; ++i) {
+        source.push_back(i % 3 == 0);
+    }
+
+    // create() replaces a file which is not a bitmap file
+    write_file(path, "This is a text file, not a bitmap file.\n");
+    assert(rejects(path));
+    {
+        MappedBitSet created = MappedBitSet::create(path, source);
+        assert(created.size() == 100);
+    }
+    {
+        MappedBitSet opened(path);
+        assert(opened.size() == 100);
+        for (size_t i = 0; i < 100; ++i) {
+            assert(opened[i] == (i % 3 == 0));
+        }
+    }
+
+    // create() also replaces a bigger bitmap file
+    {
+        BitSet small;
+        small.push_back(true);
+        MappedBitSet::create(path, small);
+
+        MappedBitSet opened(path);
+        assert(opened.size() == 1 && opened[0]);
+    }
+
+    // A failed resize() leaves the set as it was
+    {
+        MappedBitSet bits = MappedBitSet::create(path, source);
+
+        // ftruncate fails: the file may not grow past the limit
+        std::signal(SIGXFSZ, SIG_IGN);
+        rlimit old_file_limit;
+        getrlimit(RLIMIT_FSIZE, &old_file_limit);
+        rlimit file_limit = old_file_limit;
+        file_limit.rlim_cur = 1 << 20;
+        setrlimit(RLIMIT_FSIZE, &file_limit);
+
+        assert(resize_error(bits, size_t(1) << 24) == EFBIG);
+        setrlimit(RLIMIT_FSIZE, &old_file_limit);
+        check_pattern(bits, 100);
+
+        // mmap fails after the file was extended: there is not enough address space
+        rlimit old_memory_limit;
+        getrlimit(RLIMIT_AS, &old_memory_limit);
+        rlimit memory_limit = old_memory_limit;
+        memory_limit.rlim_cur = rlim_t(1) << 32;
+        setrlimit(RLIMIT_AS, &memory_limit);
+
+        assert(resize_error(bits, size_t(1) << 36) != 0);
+        setrlimit(RLIMIT_AS, &old_memory_limit);
+        check_pattern(bits, 100);
+
+        bits.resize(50);
+        check_pattern(bits, 50);
+        bits.resize(100);
+        assert(!bits[51] && !bits[99]);
+    }
+
+    // A header with a bit count so big that rounding it up to bytes would
+    // wrap around must not pass the check against the file size
+    std::string header("BITSET01", 8);
+    for (int i = 0; i < 8; ++i) {
+        header += char(0xFF);
+    }
+    write_file(path, header);
+    assert(rejects(path));
+
+    std::remove(path.c_str());
+    std::cout << "All MappedBitSet checks passed\n";
+    return 0;
+}
@@ -1,6 +1,9 @@
 #pragma once
+#include <functional>
 #include <utility>
 
+#include "listMergeSort.hpp"
+
 template <typename T>
 class DoublyLinkedList {
 public:
@@ -16,7 +19,7 @@ public:
       while (next) {
         last->next = new Node(next->data, last);
         last = last->next;
-        next->next = next;
+        next = next->next;
       }
     }
   }
@@ -198,10 +201,131 @@ class Iterator {
     return first_it == last_it || first_it->prev == last_it;
   }
 
+  // Appends copies of the elements of other
+  void append(const DoublyLinkedList& other) {
+    DoublyLinkedList copy(other);
+    append(std::move(copy));
+  }
+
+  // Moves all nodes of other to the end of this list in O(1). other is left empty.
+  void append(DoublyLinkedList&& other) {
+    splice(end(), other);
+  }
+
+  // Moves all nodes of other before position in O(1). Nothing is copied or allocated.
+  void splice(const Iterator& position, DoublyLinkedList& other) {
+    if (&other == this || other.empty()) {
+      return;
+    }
+
+    Node* chain_first = other.first;
+    Node* chain_last = other.last;
+    std::size_t count = other.size;
+
+    other.first = other.last = nullptr;
+    other.size = 0;
+
+    link_before(position, chain_first, chain_last, count);
+  }
+
+  // Moves the nodes in [range_first, range_last) of other before position.
+  // other may be this list, as long as position is not inside the range.
+  // The relinking is O(1), but the moved nodes have to be counted to keep
+  // the sizes right, so this is linear in their number.
+  void splice(const Iterator& position, DoublyLinkedList& other, const Iterator& range_first, const Iterator& range_last) {
+    if (range_first == range_last) {
+      return;
+    }
+
+    Node* before = range_first.current->prev;
+    Node* after = range_last.current;
+    Node* chain_last = after ? after->prev : other.last;
+
+    std::size_t count = 1;
+    for (Node* iter = range_first.current; iter != chain_last; iter = iter->next) {
+      ++count;
+    }
+
+    // Detach the range from other
+    if (before) {
+      before->next = after;
+    } else {
+      other.first = after;
+    }
+
+    if (after) {
+      after->prev = before;
+    } else {
+      other.last = before;
+    }
+
+    other.size -= count;
+
+    link_before(position, range_first.current, chain_last, count);
+  }
+
+  // Moves the nodes from position to the end into a new list, which is returned.
+  // Linear in the number of moved nodes, because they have to be counted.
+  DoublyLinkedList split_at(const Iterator& position) {
+    DoublyLinkedList tail;
+    tail.splice(tail.end(), *this, position, end());
+    return tail;
+  }
+
+  // Stable bottom-up merge sort. The nodes are merged by their `next` links
+  // and the `prev` links are restored in one pass at the end, so no memory
+  // is allocated and iterators keep pointing to the same values.
+  template <typename Compare = std::less<T>>
+  void sort(Compare less = Compare()) {
+    last = list_merge_sort::sort(first, size, less);
+    relink_prev();
+  }
+
 private:
   Node *first, *last;
   std::size_t size;
 
+  // Links the chain chain_first <-> ... <-> chain_last of `count` nodes before position
+  void link_before(const Iterator& position, Node* chain_first, Node* chain_last, std::size_t count) {
+    if (position == end()) {
+      chain_first->prev = last;
+      chain_last->next = nullptr;
+
+      if (empty()) {
+        first = chain_first;
+      } else {
+        last->next = chain_first;
+      }
+
+      last = chain_last;
+    } else {
+      Node* next = position.current;
+      Node* prev = next->prev;
+
+      chain_first->prev = prev;
+      chain_last->next = next;
+      next->prev = chain_last;
+
+      if (prev) {
+        prev->next = chain_first;
+      } else {
+        first = chain_first;
+      }
+    }
+
+    size += count;
+  }
+
+  // Restores the `prev` links from the `next` links
+  void relink_prev() {
+    Node* prev = nullptr;
+
+    for (Node* iter = first; iter; iter = iter->next) {
+      iter->prev = prev;
+      prev = iter;
+    }
+  }
+
   void swap(DoublyLinkedList& other) {
     std::swap(first, other.first);
     std::swap(last, other.last);
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Doubly linked list whose nodes live in one contiguous array.
+//
+// Instead of allocating every node with `new`, the nodes are kept in a
+// std::vector and linked with 32-bit indices, so a link costs 8 bytes
+// instead of 16 and the nodes stay close together in memory. Removed
+// nodes go to a free list and are reused by the next insertion.
+//
+// After many insertions and removals the traversal order may jump around
+// the array. compact() moves the nodes into traversal order, so that
+// iterating the list walks the array sequentially.
+//
+// The interface follows DoublyLinkedList.
+template <typename T>
+class IndexedList {
+private:
+  using index_type = std::uint32_t;
+  static constexpr index_type npos = UINT32_MAX;
+
+  struct Node {
+    T data;
+    index_type prev, next;
+
+    Node(const T& data, index_type prev, index_type next) : data(data), prev(prev), next(next) {}
+    Node(T&& data, index_type prev, index_type next) : data(std::move(data)), prev(prev), next(next) {}
+  };
+
+public:
+  class Iterator {
+  public:
+    bool operator!=(const Iterator& other) const {
+      return current != other.current;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return !(*this != other);
+    }
+
+    Iterator& operator++() {
+      current = list->nodes[current].next;
+      return *this;
+    }
+
+    // Decrementing end() gives the last element
+    Iterator& operator--() {
+      current = current == npos ? list->last : list->nodes[current].prev;
+      return *this;
+    }
+
+    const T& operator*() const {
+      return list->nodes[current].data;
+    }
+
+  private:
+    friend class IndexedList<T>;
+
+    Iterator(const IndexedList* list, index_type current) : list(list), current(current) {}
+
+    const IndexedList* list;
+    index_type current;
+  };
+
+  IndexedList() : first(npos), last(npos), free_first(npos), size(0) {}
+
+  // The copy keeps the same array layout, so it is as compact as the original
+  IndexedList(const IndexedList& other) = default;
+
+  IndexedList& operator=(const IndexedList& other) {
+    IndexedList copy(other);
+    swap(copy);
+
+    return *this;
+  }
+
+  IndexedList(IndexedList&& other)
+    : nodes(std::move(other.nodes)), first(other.first), last(other.last),
+      free_first(other.free_first), size(other.size) {
+    other.nodes.clear();
+    other.first = other.last = other.free_first = npos;
+    other.size = 0;
+  }
+
+  IndexedList& operator=(IndexedList&& other) {
+    IndexedList copy(std::move(other));
+    swap(copy);
+
+    return *this;
+  }
+
+  bool empty() const {
+    return size == 0;
+  }
+
+  std::size_t get_size() const {
+    return size;
+  }
+
+  // Number of nodes the array can hold without reallocating
+  std::size_t capacity() const {
+    return nodes.capacity();
+  }
+
+  void reserve(std::size_t count) {
+    nodes.reserve(count);
+  }
+
+  void insert_last(const T& data) {
+    link_before(npos, data);
+  }
+
+  void insert_first(const T& data) {
+    link_before(first, data);
+  }
+
+  void remove_first() {
+    unlink(first);
+  }
+
+  void remove_last() {
+    unlink(last);
+  }
+
+  Iterator begin() const {
+    return Iterator(this, first);
+  }
+
+  Iterator end() const {
+    return Iterator(this, npos);
+  }
+
+  Iterator last_i() const {
+    return Iterator(this, last);
+  }
+
+  // Unlike the pointer-based lists, both operations are O(1), because every node knows its predecessor
+  void insert_before(const T& data, const Iterator& position) {
+    link_before(position.current, data);
+  }
+
+  void remove_at(const Iterator& position) {
+    unlink(position.current);
+  }
+
+  // Moves the nodes into traversal order and releases the free ones.
+  // Invalidates all iterators.
+  void compact() {
+    std::vector<Node> ordered;
+    ordered.reserve(size);
+
+    for (index_type iter = first; iter != npos; iter = nodes[iter].next) {
+      index_type position = static_cast<index_type>(ordered.size());
+      ordered.emplace_back(std::move(nodes[iter].data), position - 1, position + 1);
+    }
+
+    if (!ordered.empty()) {
+      ordered.front().prev = npos;
+      ordered.back().next = npos;
+    }
+
+    nodes.swap(ordered);
+    first = size ? 0 : npos;
+    last = size ? static_cast<index_type>(size - 1) : npos;
+    free_first = npos;
+  }
+
+private:
+  // Nodes in use and free nodes. Free nodes are chained through `next`
+  // and keep their last value until they are reused or compacted away.
+  std::vector<Node> nodes;
+  index_type first, last;
+  index_type free_first;
+  std::size_t size;
+
+  void swap(IndexedList& other) {
+    std::swap(nodes, other.nodes);
+    std::swap(first, other.first);
+    std::swap(last, other.last);
+    std::swap(free_first, other.free_first);
+    std::swap(size, other.size);
+  }
+
+  // Inserts a node before `next` (npos means at the end)
+  void link_before(index_type next, const T& data) {
+    index_type prev = next == npos ? last : nodes[next].prev;
+    index_type node;
+
+    if (free_first != npos) {
+      node = free_first;
+      free_first = nodes[node].next;
+      nodes[node].data = data;
+      nodes[node].prev = prev;
+      nodes[node].next = next;
+    } else {
+      if (nodes.size() >= npos) {
+        throw std::length_error("IndexedList cannot hold more than 2^32 - 1 elements");
+      }
+      node = static_cast<index_type>(nodes.size());
+
+      if (nodes.size() == nodes.capacity()) {
+        // data may live in this array; copy it before the array is reallocated
+        T copy(data);
+        nodes.emplace_back(std::move(copy), prev, next);
+      } else {
+        nodes.emplace_back(data, prev, next);
+      }
+    }
+
+    (prev == npos ? first : nodes[prev].next) = node;
+    (next == npos ? last : nodes[next].prev) = node;
+    ++size;
+  }
+
+  void unlink(index_type node) {
+    index_type prev = nodes[node].prev;
+    index_type next = nodes[node].next;
+
+    (prev == npos ? first : nodes[prev].next) = next;
+    (next == npos ? last : nodes[next].prev) = prev;
+
+    nodes[node].next = free_first;
+    free_first = node;
+    --size;
+  }
+};
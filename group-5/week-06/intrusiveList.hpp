@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Intrusive doubly linked list.
+//
+// DoublyLinkedList copies every element into a node allocated with `new`.
+// Here the links live inside the elements themselves (a "hook"), so the
+// list only connects objects that already exist - for example objects
+// from a pool. Inserting and removing never allocate, and an element can
+// be removed in O(1) given just a reference to it.
+//
+// The list does not own its elements: they must outlive their membership
+// and are not destroyed by the list.
+//
+// An element type gets its hooks in one of two ways:
+//
+//   // As a base class. Different tags give an object several hooks.
+//   struct Task : ListBaseHook<>, ListBaseHook<struct ByPriority> { ... };
+//   IntrusiveList<Task> queue;
+//   IntrusiveList<Task, BaseHook<ByPriority>> by_priority;
+//
+//   // As a member of a standard-layout type
+//   struct Job { ListHook hook; ... };
+//   IntrusiveList<Job, MemberHook<Job, &Job::hook, offsetof(Job, hook)>> jobs;
+//
+// In debug builds (without NDEBUG) the hooks check that an element is not
+// inserted twice, not removed when it is not in a list (or is in another
+// list) and not destroyed while still in a list.
+
+class ListHook {
+public:
+  ListHook() = default;
+
+  // Copying an element does not put the copy in the original's list
+  ListHook(const ListHook&) {}
+
+  ListHook& operator=(const ListHook&) {
+    return *this;
+  }
+
+  ~ListHook() {
+    assert(!is_linked() && "An element was destroyed while still in an intrusive list");
+  }
+
+  bool is_linked() const {
+    return next != nullptr;
+  }
+
+private:
+  template <typename T, typename Hook>
+  friend class IntrusiveList;
+
+  ListHook* prev = nullptr;
+  ListHook* next = nullptr;
+
+#ifndef NDEBUG
+  // The list the element is in, so that removing it from another list is caught
+  const void* owner = nullptr;
+#endif
+};
+
+// Base class which gives an element a hook. Use different tags for several hooks.
+template <typename Tag = void>
+class ListBaseHook : public ListHook {};
+
+// Selects the ListBaseHook<Tag> base of the elements
+template <typename Tag = void>
+struct BaseHook {
+  template <typename T>
+  static ListHook& to_hook(T& value) {
+    return static_cast<ListBaseHook<Tag>&>(value);
+  }
+
+  template <typename T>
+  static T& to_value(ListHook& hook) {
+    return static_cast<T&>(static_cast<ListBaseHook<Tag>&>(hook));
+  }
+};
+
+// Selects a ListHook data member of the elements.
+//
+// Getting from the hook back to the element needs the member's offset,
+// which C++ only defines (through offsetof) for standard-layout types.
+template <typename T, ListHook T::*Member, std::size_t Offset>
+struct MemberHook {
+  static_assert(std::is_standard_layout_v<T>, "MemberHook needs a standard-layout element type");
+
+  template <typename U>
+  static ListHook& to_hook(U& value) {
+    ListHook& hook = value.*Member;
+    assert(reinterpret_cast<char*>(&hook) - reinterpret_cast<char*>(&value) == static_cast<std::ptrdiff_t>(Offset) &&
+           "Offset is not the offset of Member");
+    return hook;
+  }
+
+  template <typename U>
+  static U& to_value(ListHook& hook) {
+    return *reinterpret_cast<U*>(reinterpret_cast<char*>(&hook) - Offset);
+  }
+};
+
+template <typename T, typename Hook = BaseHook<>>
+class IntrusiveList {
+public:
+  class Iterator {
+  public:
+    bool operator!=(const Iterator& other) const {
+      return current != other.current;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return !(*this != other);
+    }
+
+    Iterator& operator++() {
+      current = current->next;
+      return *this;
+    }
+
+    Iterator& operator--() {
+      current = current->prev;
+      return *this;
+    }
+
+    T& operator*() const {
+      return Hook::template to_value<T>(*current);
+    }
+
+    T* operator->() const {
+      return &**this;
+    }
+
+  private:
+    friend class IntrusiveList;
+
+    explicit Iterator(ListHook* current) : current(current) {}
+
+    ListHook* current;
+  };
+
+  // The list is circular around `root`, so there are no special cases for
+  // the ends: root.next is the first element and root.prev the last one.
+  IntrusiveList() : size(0) {
+    root.next = root.prev = &root;
+  }
+
+  // Copying would have to put the same elements in two lists with one hook
+  IntrusiveList(const IntrusiveList&) = delete;
+  IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+  IntrusiveList(IntrusiveList&& other) : IntrusiveList() {
+    swap(other);
+  }
+
+  IntrusiveList& operator=(IntrusiveList&& other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  // Unlinks the elements; they are not destroyed
+  ~IntrusiveList() {
+    clear();
+    root.next = root.prev = nullptr; // the root hook is not an element
+  }
+
+  bool empty() const {
+    return size == 0;
+  }
+
+  std::size_t get_size() const {
+    return size;
+  }
+
+  T& front() {
+    return Hook::template to_value<T>(*root.next);
+  }
+
+  T& back() {
+    return Hook::template to_value<T>(*root.prev);
+  }
+
+  void insert_first(T& value) {
+    link_before(root.next, Hook::to_hook(value));
+  }
+
+  void insert_last(T& value) {
+    link_before(&root, Hook::to_hook(value));
+  }
+
+  void insert_before(T& value, const Iterator& position) {
+    link_before(position.current, Hook::to_hook(value));
+  }
+
+  void remove_first() {
+    unlink(root.next);
+  }
+
+  void remove_last() {
+    unlink(root.prev);
+  }
+
+  // Returns an iterator to the element after the removed one
+  Iterator remove_at(const Iterator& position) {
+    ListHook* next = position.current->next;
+    unlink(position.current);
+    return Iterator(next);
+  }
+
+  // Removes an element of this list in O(1), given only a reference to it
+  void remove(T& value) {
+    unlink(&Hook::to_hook(value));
+  }
+
+  // Iterator to an element of this list, found in O(1)
+  Iterator iterator_to(T& value) {
+    return Iterator(&Hook::to_hook(value));
+  }
+
+  // Unlinks all elements
+  void clear() {
+    while (!empty()) {
+      remove_first();
+    }
+  }
+
+  Iterator begin() {
+    return Iterator(root.next);
+  }
+
+  Iterator end() {
+    return Iterator(&root);
+  }
+
+  Iterator last_i() {
+    return Iterator(root.prev);
+  }
+
+private:
+  ListHook root;
+  std::size_t size;
+
+  void link_before(ListHook* next, ListHook& hook) {
+    assert(!hook.is_linked() && "The element is already in a list which uses this hook");
+    assert((next == &root || next->owner == this) && "The position is not in this list");
+
+#ifndef NDEBUG
+    hook.owner = this;
+#endif
+    hook.prev = next->prev;
+    hook.next = next;
+    next->prev->next = &hook;
+    next->prev = &hook;
+    ++size;
+  }
+
+  void unlink(ListHook* hook) {
+    assert(hook != &root && "Removing from an empty list");
+    assert(hook->is_linked() && "The element is not in a list");
+    assert(hook->owner == this && "The element is in another list");
+
+#ifndef NDEBUG
+    hook->owner = nullptr;
+#endif
+    hook->prev->next = hook->next;
+    hook->next->prev = hook->prev;
+    hook->prev = hook->next = nullptr;
+    --size;
+  }
+
+  void swap(IntrusiveList& other) {
+    std::swap(root.next, other.root.next);
+    std::swap(root.prev, other.root.prev);
+    std::swap(size, other.size);
+
+    // The first and last elements point back at the root they belong to
+    fix_root();
+    other.fix_root();
+  }
+
+  void fix_root() {
+    if (size == 0) {
+      root.next = root.prev = &root;
+    } else {
+      root.next->prev = &root;
+      root.prev->next = &root;
+    }
+
+#ifndef NDEBUG
+    // The elements changed lists, O(n) but only in debug builds
+    for (ListHook* hook = root.next; hook != &root; hook = hook->next) {
+      hook->owner = this;
+    }
+#endif
+  }
+};
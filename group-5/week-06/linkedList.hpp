@@ -1,7 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <functional>
 #include <iostream>
 #include <utility>
+#include <vector>
+
+#include "listMergeSort.hpp"
 
 template <typename T>
 class LinkedList {
@@ -13,13 +19,115 @@ private:
     Node(const T& data, Node* const next = nullptr) : data(data), next(next) {}
   };
 
+  // The set operations below pick a strategy depending on what T supports
+  static constexpr bool hashable = requires(const T& value) {
+    { std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+    { value == value } -> std::convertible_to<bool>;
+  };
+
+  static constexpr bool ordered = requires(const T& value) {
+    { value < value } -> std::convertible_to<bool>;
+  };
+
+  // Below this many comparisons a nested scan is faster than building an index
+  static constexpr std::size_t nested_scan_limit = 256;
+
+  // Open-addressing hash set of pointers to values stored in the list's nodes.
+  // Uses linear probing in a power-of-two table kept at most half full.
+  class ValueSet {
+  public:
+    explicit ValueSet(std::size_t expected) {
+      std::size_t capacity = 16;
+      while (capacity < 2 * expected) {
+        capacity *= 2;
+      }
+      table.assign(capacity, nullptr);
+    }
+
+    // Returns false if an equal value is already in the set
+    bool insert(const T& value) {
+      if (2 * (count + 1) > table.size()) {
+        grow();
+      }
+
+      std::size_t slot = find_slot(value);
+      if (table[slot]) {
+        return false;
+      }
+
+      table[slot] = &value;
+      ++count;
+      return true;
+    }
+
+    bool contains(const T& value) const {
+      return table[find_slot(value)] != nullptr;
+    }
+
+  private:
+    std::vector<const T*> table;
+    std::size_t count = 0;
+
+    // The slot holding a value equal to `value`, or the empty slot where it belongs
+    std::size_t find_slot(const T& value) const {
+      std::size_t mask = table.size() - 1;
+      // std::hash is often the identity for integers, so spread the bits
+      std::size_t slot = (std::hash<T>{}(value) * 0x9e3779b97f4a7c15ULL) >> 20 & mask;
+
+      while (table[slot] && !(*table[slot] == value)) {
+        slot = (slot + 1) & mask;
+      }
+
+      return slot;
+    }
+
+    void grow() {
+      std::vector<const T*> old(2 * table.size(), nullptr);
+      old.swap(table);
+
+      for (const T* value : old) {
+        if (value) {
+          table[find_slot(*value)] = value;
+        }
+      }
+    }
+  };
+
+  // Pointers to the values of a list, sorted, for binary search
+  static std::vector<const T*> sorted_values(const LinkedList& list) {
+    std::vector<const T*> values;
+    values.reserve(list.size);
+
+    for (Node* iter = list.first; iter; iter = iter->next) {
+      values.push_back(&iter->data);
+    }
+
+    std::sort(values.begin(), values.end(), [](const T* left, const T* right) { return *left < *right; });
+    return values;
+  }
+
+  static bool sorted_contains(const std::vector<const T*>& values, const T& value) {
+    auto position = std::lower_bound(values.begin(), values.end(), &value,
+                                     [](const T* left, const T* right) { return *left < *right; });
+    return position != values.end() && !(value < **position);
+  }
+
+  bool scan_contains(const T& value) const {
+    for (Node* iter = first; iter; iter = iter->next) {
+      if (iter->data == value) {
+        return true;
+      }
+    }
+    return false;
+  }
+
 public:
   class Iterator {
   public:
-    Iterator(Node* const current) : current(current) {}
+    Iterator(Node* const current) : current(current), before_first_of(nullptr) {}
 
     bool operator!=(const Iterator& other) const {
-      return current != other.current;
+      return current != other.current || before_first_of != other.before_first_of;
     }
 
     bool operator==(const Iterator& other) const {
@@ -27,7 +135,12 @@ public:
     }
 
     Iterator& operator++() {
-      current = current->next;
+      if (before_first_of) {
+        current = before_first_of->first;
+        before_first_of = nullptr;
+      } else {
+        current = current->next;
+      }
       return *this;
     }
 
@@ -42,7 +155,14 @@ public:
   private:
     friend class LinkedList<T>;
 
+    // Iterator to the position before the first element of list
+    Iterator(Node* const current, const LinkedList* before_first_of)
+      : current(current), before_first_of(before_first_of) {}
+
     Node* current;
+
+    // Set only for the iterator returned by before_begin()
+    const LinkedList* before_first_of;
   };
 
   LinkedList(): first(nullptr), last(nullptr), size(0) {}
@@ -70,6 +190,7 @@ public:
   : first(other.first), last(other.last), size(other.size) {
     other.first = nullptr;
     other.last = nullptr;
+    other.size = 0;
   }
   LinkedList<T>& operator=(LinkedList<T>&& other) {
     LinkedList<T> copy(std::move(other));
@@ -112,16 +233,63 @@ public:
     ++size;
   }
 
-  void insert_after(const T& data, const Iterator& position) {
+  // Inserts after position in O(1) and returns an iterator to the new element.
+  // Use before_begin() to insert at the front.
+  Iterator insert_after(const T& data, const Iterator& position) {
+    if (position.before_first_of) {
+      insert_first(data);
+      return begin();
+    }
+
     if (position == Iterator(last)) {
       insert_last(data);
-    } else {
-      Node* new_element = new Node(data, position.current->next);
-      position.current->next = new_element;
-      ++size;
+      return Iterator(last);
     }
+
+    Node* new_element = new Node(data, position.current->next);
+    position.current->next = new_element;
+    ++size;
+    return Iterator(new_element);
   }
 
+  // Removes the element after position in O(1) and returns an iterator to
+  // the element which followed it. Use before_begin() to remove the first element.
+  //
+  // Unlike remove_at(), this does not have to look for the previous node,
+  // so editing a list in one pass with a "before" iterator stays linear.
+  Iterator erase_after(const Iterator& position) {
+    if (position.before_first_of) {
+      remove_first();
+      return begin();
+    }
+
+    remove_after(position.current);
+    return Iterator(position.current->next);
+  }
+
+  // Removes every element for which remove(value) is true, in one pass.
+  // Returns the number of removed elements.
+  template <typename Predicate>
+  std::size_t remove_if(Predicate remove) {
+    std::size_t old_size = size;
+
+    Iterator before = before_begin();
+    Iterator current = begin();
+
+    while (current != end()) {
+      if (remove(*current)) {
+        current = erase_after(before);
+      } else {
+        before = current;
+        ++current;
+      }
+    }
+
+    return old_size - size;
+  }
+
+  // Has to find the node before position, which takes linear time.
+  // Prefer insert_after() when walking through the list.
   void insert_before(const T& data, const Iterator& position) {
     if (position == Iterator(first)) {
       insert_first(data);
@@ -165,6 +333,8 @@ public:
     --size;
   }
 
+  // Has to find the node before position, which takes linear time.
+  // Prefer erase_after() when walking through the list.
   void remove_at(const Iterator& position) {
     if (position == begin()) {
       remove_first();
@@ -179,6 +349,138 @@ public:
     }
   }
 
+  // Appends copies of the elements of other
+  void append(const LinkedList& other) {
+    LinkedList copy(other);
+    append(std::move(copy));
+  }
+
+  // Moves all nodes of other to the end of this list in O(1). other is left empty.
+  void append(LinkedList&& other) {
+    splice(end(), other);
+  }
+
+  // Moves all nodes of other before position. Nothing is copied or allocated.
+  // O(1) when position is begin() or end(), otherwise the node before
+  // position has to be found first.
+  void splice(const Iterator& position, LinkedList& other) {
+    if (&other == this || other.empty()) {
+      return;
+    }
+
+    Node* chain_first = other.first;
+    Node* chain_last = other.last;
+    std::size_t count = other.size;
+
+    other.first = other.last = nullptr;
+    other.size = 0;
+
+    link_before(position, chain_first, chain_last, count);
+  }
+
+  // Moves the nodes in [range_first, range_last) of other before position.
+  // other may be this list, as long as position is not inside the range.
+  // The moved nodes have to be counted, so this is linear in their number.
+  void splice(const Iterator& position, LinkedList& other, const Iterator& range_first, const Iterator& range_last) {
+    if (range_first == range_last) {
+      return;
+    }
+
+    Node* before = range_first == other.begin() ? nullptr : other.previous(range_first.current);
+
+    Node* chain_last = range_first.current;
+    std::size_t count = 1;
+    while (chain_last->next != range_last.current) {
+      chain_last = chain_last->next;
+      ++count;
+    }
+
+    // Detach the range from other
+    if (before) {
+      before->next = range_last.current;
+    } else {
+      other.first = range_last.current;
+    }
+
+    if (!range_last.current) {
+      other.last = before;
+    }
+
+    other.size -= count;
+
+    link_before(position, range_first.current, chain_last, count);
+  }
+
+  // Moves the nodes from position to the end into a new list, which is returned.
+  // Linear, because the node before position has to be found and the moved nodes counted.
+  LinkedList split_at(const Iterator& position) {
+    LinkedList tail;
+    tail.splice(tail.end(), *this, position, end());
+    return tail;
+  }
+
+  // Removes repeating elements, keeping the first occurrence of each value.
+  // Near-linear for hashable or ordered T; a nested scan is used for short
+  // lists and for types that only support ==.
+  void unique() {
+    if constexpr (hashable) {
+      if (size * size > nested_scan_limit) {
+        ValueSet seen(size);
+        remove_if([&seen](const T& value) { return !seen.insert(value); });
+        return;
+      }
+    }
+
+    if constexpr (ordered) {
+      if (size * size > nested_scan_limit) {
+        unique_by_sorting();
+        return;
+      }
+    }
+
+    for (Node* iter = first; iter; iter = iter->next) {
+      Node* prev = iter;
+      while (prev->next) {
+        if (prev->next->data == iter->data) {
+          remove_after(prev);
+        } else {
+          prev = prev->next;
+        }
+      }
+    }
+  }
+
+  // Keeps only the elements that also occur in other
+  void intersection(const LinkedList& other) {
+    filter_by(other, true);
+  }
+
+  // Removes the elements that occur in other
+  void difference(const LinkedList& other) {
+    filter_by(other, false);
+  }
+
+  // Appends the values of other which do not occur in this list, each one once
+  void union_with(const LinkedList& other) {
+    LinkedList missing(other);
+    missing.difference(*this);
+    missing.unique();
+    append(std::move(missing));
+  }
+
+  // Stable bottom-up merge sort. Only the links between the nodes change,
+  // so no memory is allocated and iterators keep pointing to the same values.
+  template <typename Compare = std::less<T>>
+  void sort(Compare less = Compare()) {
+    last = list_merge_sort::sort(first, size, less);
+  }
+
+  // The position before the first element. It can be passed to insert_after()
+  // and erase_after() and incrementing it gives begin().
+  Iterator before_begin() const {
+    return Iterator(nullptr, this);
+  }
+
   Iterator begin() const {
     return Iterator(first);
   }
@@ -197,6 +499,103 @@ private:
     std::swap(size, other.size);
   }
 
+  // Removes the node after prev, which must exist
+  void remove_after(Node* prev) {
+    Node* victim = prev->next;
+    prev->next = victim->next;
+
+    if (victim == last) {
+      last = prev;
+    }
+
+    delete victim;
+    --size;
+  }
+
+  // Keeps the elements which occur (keep_found == true) or do not occur in other
+  void filter_by(const LinkedList& other, bool keep_found) {
+    if (&other == this) {
+      if (!keep_found) {
+        while (!empty()) {
+          remove_first();
+        }
+      }
+      return;
+    }
+
+    if constexpr (hashable) {
+      if (size * other.size > nested_scan_limit) {
+        ValueSet values(other.size);
+        for (Node* iter = other.first; iter; iter = iter->next) {
+          values.insert(iter->data);
+        }
+
+        remove_if([&](const T& value) { return values.contains(value) != keep_found; });
+        return;
+      }
+    }
+
+    if constexpr (ordered) {
+      if (size * other.size > nested_scan_limit) {
+        std::vector<const T*> values = sorted_values(other);
+        remove_if([&](const T& value) { return sorted_contains(values, value) != keep_found; });
+        return;
+      }
+    }
+
+    remove_if([&](const T& value) { return other.scan_contains(value) != keep_found; });
+  }
+
+  // unique() for types which can be ordered, but not hashed.
+  // A stable sort of the positions groups equal values together with the
+  // first occurrence in front; all other members of a group are removed.
+  void unique_by_sorting() {
+    std::vector<std::pair<const T*, std::size_t>> positions;
+    positions.reserve(size);
+
+    std::size_t index = 0;
+    for (Node* iter = first; iter; iter = iter->next) {
+      positions.emplace_back(&iter->data, index++);
+    }
+
+    std::stable_sort(positions.begin(), positions.end(),
+                     [](const auto& left, const auto& right) { return *left.first < *right.first; });
+
+    std::vector<bool> repeated(size, false);
+    for (std::size_t i = 1; i < positions.size(); ++i) {
+      if (!(*positions[i - 1].first < *positions[i].first)) {
+        repeated[positions[i].second] = true;
+      }
+    }
+
+    index = 0;
+    remove_if([&](const T&) { return repeated[index++]; });
+  }
+
+  // Links the chain chain_first -> ... -> chain_last of `count` nodes before position
+  void link_before(const Iterator& position, Node* chain_first, Node* chain_last, std::size_t count) {
+    if (position == end()) {
+      chain_last->next = nullptr;
+
+      if (empty()) {
+        first = chain_first;
+      } else {
+        last->next = chain_first;
+      }
+
+      last = chain_last;
+    } else if (position == begin()) {
+      chain_last->next = first;
+      first = chain_first;
+    } else {
+      Node* prev = previous(position.current);
+      chain_last->next = position.current;
+      prev->next = chain_first;
+    }
+
+    size += count;
+  }
+
   Node* previous(Node* current) {
     Node* iter = first;
 
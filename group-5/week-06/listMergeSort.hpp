@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+
+// Stable bottom-up merge sort of a chain of nodes linked by `next`, shared
+// by LinkedList and DoublyLinkedList. Only the `next` links change, so no
+// memory is allocated and the nodes keep their values. A doubly linked
+// list has to restore its `prev` links afterwards.
+namespace list_merge_sort {
+
+// Detaches the chain after its first `count` nodes and returns the detached part
+template <typename Node>
+Node* cut_after(Node* head, std::size_t count) {
+  for (std::size_t i = 1; head && i < count; ++i) {
+    head = head->next;
+  }
+
+  if (!head) {
+    return nullptr;
+  }
+
+  Node* rest = head->next;
+  head->next = nullptr;
+  return rest;
+}
+
+// Merges two sorted chains into `head` and returns the last node.
+// On equal values the node from `left` goes first, which keeps the sort stable.
+template <typename Node, typename Compare>
+Node* merge(Node* left, Node* right, Node*& head, Compare& less) {
+  Node** tail = &head;
+  Node* merged_last = nullptr;
+
+  while (left && right) {
+    Node*& smaller = less(right->data, left->data) ? right : left;
+    *tail = merged_last = smaller;
+    tail = &smaller->next;
+    smaller = smaller->next;
+  }
+
+  *tail = left ? left : right;
+
+  while (*tail) {
+    merged_last = *tail;
+    tail = &merged_last->next;
+  }
+
+  return merged_last;
+}
+
+// Sorts the chain of `size` nodes starting at `first` and returns its new last node
+template <typename Node, typename Compare>
+Node* sort(Node*& first, std::size_t size, Compare& less) {
+  if (size < 2) {
+    return first;
+  }
+
+  Node* last = nullptr;
+
+  for (std::size_t width = 1; width < size; width *= 2) {
+    Node* rest = first;
+    Node** tail = &first;
+
+    // Merge neighbouring runs of `width` nodes into runs of 2 * width
+    while (rest) {
+      Node* left = rest;
+      Node* right = cut_after(left, width);
+      rest = cut_after(right, width);
+
+      last = merge(left, right, *tail, less);
+      tail = &last->next;
+    }
+  }
+
+  return last;
+}
+
+} // namespace list_merge_sort
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+// Queues which can be used from several threads without a mutex.
+//
+// SpscQueue - one producer thread and one consumer thread, bounded,
+//             wait-free (every operation finishes in a bounded number of steps).
+// MpscQueue - any number of producer threads and one consumer thread,
+//             unbounded, lock-free, intrusive (the elements carry the links).
+
+// The head and the tail are written by different threads. If they shared a
+// cache line, every write by one thread would evict the line from the
+// other thread's cache ("false sharing"), so they are padded apart.
+constexpr std::size_t cache_line_size = 64;
+
+// Bounded single-producer single-consumer ring buffer.
+//
+// The producer only writes `tail` and the consumer only writes `head`, so
+// plain loads and stores with acquire/release ordering are enough.
+// Each side also keeps a cached copy of the other side's index and only
+// reloads it when the queue looks full (or empty), which avoids touching
+// the other thread's cache line on most operations.
+//
+// T must be default constructible and move assignable.
+template <typename T>
+class SpscQueue {
+private:
+  std::unique_ptr<T[]> buffer;
+  std::size_t mask;
+
+  // Consumer side
+  alignas(cache_line_size) std::atomic<std::size_t> head{0};
+  std::size_t cached_tail = 0;
+
+  // Producer side
+  alignas(cache_line_size) std::atomic<std::size_t> tail{0};
+  std::size_t cached_head = 0;
+
+  static std::size_t round_up_to_power_of_two(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+      result *= 2;
+    }
+    return result;
+  }
+
+public:
+  // Capacity is rounded up to a power of two, so that positions can be
+  // wrapped with a bit mask instead of a division
+  explicit SpscQueue(std::size_t capacity) {
+    if (capacity == 0) {
+      throw std::invalid_argument("SpscQueue capacity must be positive");
+    }
+    std::size_t size = round_up_to_power_of_two(capacity);
+    buffer.reset(new T[size]);
+    mask = size - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  std::size_t capacity() const {
+    return mask + 1;
+  }
+
+  // Producer only. Returns false if the queue is full.
+  bool try_push(T value) {
+    std::size_t position = tail.load(std::memory_order_relaxed);
+
+    if (position - cached_head > mask) {
+      cached_head = head.load(std::memory_order_acquire);
+      if (position - cached_head > mask) {
+        return false;
+      }
+    }
+
+    buffer[position & mask] = std::move(value);
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Producer only. Pushes as many of the `count` values as fit with a single
+  // publication and returns how many were pushed.
+  template <typename InputIt>
+  std::size_t try_push_n(InputIt values, std::size_t count) {
+    std::size_t position = tail.load(std::memory_order_relaxed);
+    std::size_t free_slots = capacity() - (position - cached_head);
+
+    if (free_slots < count) {
+      cached_head = head.load(std::memory_order_acquire);
+      free_slots = capacity() - (position - cached_head);
+    }
+
+    std::size_t pushed = count < free_slots ? count : free_slots;
+    for (std::size_t i = 0; i < pushed; ++i, ++values) {
+      buffer[(position + i) & mask] = std::move(*values);
+    }
+
+    tail.store(position + pushed, std::memory_order_release);
+    return pushed;
+  }
+
+  // Consumer only. Returns false if the queue is empty.
+  bool try_pop(T& result) {
+    std::size_t position = head.load(std::memory_order_relaxed);
+
+    if (position == cached_tail) {
+      cached_tail = tail.load(std::memory_order_acquire);
+      if (position == cached_tail) {
+        return false;
+      }
+    }
+
+    result = std::move(buffer[position & mask]);
+    head.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Moves up to `count` values to `out` and frees their slots
+  // with a single publication. Returns how many were taken.
+  template <typename OutputIt>
+  std::size_t try_pop_n(OutputIt out, std::size_t count) {
+    std::size_t position = head.load(std::memory_order_relaxed);
+    std::size_t available = cached_tail - position;
+
+    if (available < count) {
+      cached_tail = tail.load(std::memory_order_acquire);
+      available = cached_tail - position;
+    }
+
+    std::size_t taken = count < available ? count : available;
+    for (std::size_t i = 0; i < taken; ++i, ++out) {
+      *out = std::move(buffer[(position + i) & mask]);
+    }
+
+    head.store(position + taken, std::memory_order_release);
+    return taken;
+  }
+};
+
+// Link which an element of MpscQueue must contain (by deriving from it)
+struct MpscNode {
+  std::atomic<MpscNode*> next{nullptr};
+};
+
+// Unbounded multi-producer single-consumer queue after Dmitry Vyukov's
+// intrusive MPSC queue.
+//
+// A producer adds a node with a single atomic exchange of `tail` and then
+// links the previous tail to it. There is no retry loop, so producers never
+// wait for each other. The consumer walks the chain from `head`.
+//
+// Between the exchange and the link the chain is briefly broken; try_pop()
+// then reports the queue as empty even though an element is on its way.
+//
+// The queue does not own the elements. T must derive from MpscNode and a
+// node may be in the queue only once at a time.
+template <typename T>
+class MpscQueue {
+private:
+  // The consumer's end. `stub` is a dummy node, so the chain is never empty.
+  alignas(cache_line_size) MpscNode* head;
+  MpscNode stub;
+
+  // The producers' end
+  alignas(cache_line_size) std::atomic<MpscNode*> tail;
+
+  // Links the chain first -> ... -> last after the current tail
+  void link(MpscNode* first, MpscNode* last) {
+    last->next.store(nullptr, std::memory_order_relaxed);
+    MpscNode* previous = tail.exchange(last, std::memory_order_acq_rel);
+    previous->next.store(first, std::memory_order_release);
+  }
+
+public:
+  MpscQueue() : head(&stub), tail(&stub) {}
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // Any thread
+  void push(T& value) {
+    MpscNode* node = &value;
+    link(node, node);
+  }
+
+  // Any thread. Links `count` elements to each other first and then adds
+  // them with a single exchange, so they stay together in the queue.
+  void push_n(T* const* values, std::size_t count) {
+    if (count == 0) {
+      return;
+    }
+
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+      static_cast<MpscNode*>(values[i])->next.store(values[i + 1], std::memory_order_relaxed);
+    }
+
+    link(values[0], values[count - 1]);
+  }
+
+  // Consumer only. Returns nullptr if the queue is empty
+  // (or a producer is in the middle of a push).
+  T* try_pop() {
+    MpscNode* first = head;
+    MpscNode* next = first->next.load(std::memory_order_acquire);
+
+    // Skip the stub
+    if (first == &stub) {
+      if (!next) {
+        return nullptr;
+      }
+      head = next;
+      first = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+      head = next;
+      return static_cast<T*>(first);
+    }
+
+    // `first` looks like the last node. If a producer has already swapped
+    // the tail, its link will show up shortly; report empty for now.
+    if (first != tail.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+
+    // Put the stub behind the last node, so that it can be removed
+    link(&stub, &stub);
+
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+      head = next;
+      return static_cast<T*>(first);
+    }
+
+    return nullptr;
+  }
+
+  // Consumer only. Pops up to `count` elements into `out`. Returns how many were popped.
+  std::size_t try_pop_n(T** out, std::size_t count) {
+    std::size_t popped = 0;
+    while (popped < count) {
+      T* value = try_pop();
+      if (!value) {
+        break;
+      }
+      out[popped++] = value;
+    }
+    return popped;
+  }
+};
@@ -0,0 +1,201 @@
+// Stress test and throughput measurement for SpscQueue and MpscQueue.
+//
+// Build with optimizations and thread support, e.g.:
+//   g++ -std=c++20 -O2 -pthread concurrentQueueBenchmark.cpp -o concurrentQueueBenchmark
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "concurrentQueue.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct Message : MpscNode {
+  unsigned producer = 0;
+  std::uint64_t sequence = 0;
+};
+
+constexpr std::size_t batch_size = 32;
+
+// The producer sends 0, 1, 2, ... (alone or in batches); the consumer must
+// receive them in the same order. Returns messages per second, or 0 on error.
+double spsc_run(std::size_t messages, bool batched) {
+  SpscQueue<std::uint64_t> queue(1024);
+  bool in_order = true;
+
+  Clock::time_point begin = Clock::now();
+
+  std::thread producer([&]() {
+    std::uint64_t batch[batch_size];
+    std::uint64_t next = 0;
+
+    while (next < messages) {
+      if (batched) {
+        std::size_t count = std::min<std::size_t>(batch_size, messages - next);
+        for (std::size_t i = 0; i < count; ++i) {
+          batch[i] = next + i;
+        }
+        std::size_t pushed = 0;
+        while (pushed < count) {
+          std::size_t added = queue.try_push_n(batch + pushed, count - pushed);
+          if (added == 0) {
+            std::this_thread::yield(); // full, let the consumer run
+          }
+          pushed += added;
+        }
+        next += count;
+      } else if (queue.try_push(next)) {
+        ++next;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::uint64_t batch[batch_size];
+  std::uint64_t expected = 0;
+
+  while (expected < messages) {
+    std::size_t count = batched ? queue.try_pop_n(batch, batch_size) : queue.try_pop(batch[0]);
+    if (count == 0) {
+      std::this_thread::yield(); // empty, let the producer run
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      in_order = in_order && batch[i] == expected;
+      ++expected;
+    }
+  }
+
+  producer.join();
+
+  double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  return in_order ? messages / seconds : 0;
+}
+
+// Every producer sends per_producer messages (alone or in batches) to one
+// consumer. The messages of each producer must arrive in the order they
+// were sent. Returns messages per second, or 0 on error.
+double mpsc_run(unsigned producers, std::size_t per_producer, bool batched) {
+  MpscQueue<Message> queue;
+  std::vector<Message> messages(producers * per_producer);
+  std::vector<std::uint64_t> expected(producers, 0);
+  bool in_order = true;
+
+  for (unsigned p = 0; p < producers; ++p) {
+    for (std::size_t i = 0; i < per_producer; ++i) {
+      messages[p * per_producer + i].producer = p;
+      messages[p * per_producer + i].sequence = i;
+    }
+  }
+
+  std::vector<std::thread> threads;
+  std::atomic<bool> start{false};
+
+  for (unsigned p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      Message* own = &messages[p * per_producer];
+      Message* batch[batch_size];
+
+      while (!start.load(std::memory_order_acquire)) {
+      }
+
+      for (std::size_t i = 0; i < per_producer;) {
+        if (batched) {
+          std::size_t count = std::min(batch_size, per_producer - i);
+          for (std::size_t j = 0; j < count; ++j) {
+            batch[j] = &own[i + j];
+          }
+          queue.push_n(batch, count);
+          i += count;
+        } else {
+          queue.push(own[i++]);
+        }
+      }
+    });
+  }
+
+  Clock::time_point begin = Clock::now();
+  start.store(true, std::memory_order_release);
+
+  Message* batch[batch_size];
+  for (std::size_t received = 0; received < messages.size();) {
+    std::size_t count = queue.try_pop_n(batch, batch_size);
+    if (count == 0) {
+      std::this_thread::yield();
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      in_order = in_order && batch[i]->sequence == expected[batch[i]->producer]++;
+    }
+    received += count;
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  return in_order ? messages.size() / seconds : 0;
+}
+
+// The same workload with std::queue behind a mutex, for comparison
+double mutex_run(unsigned producers, std::size_t per_producer) {
+  std::queue<std::uint64_t> queue;
+  std::mutex mutex;
+  std::vector<std::thread> threads;
+  std::atomic<bool> start{false};
+
+  for (unsigned p = 0; p < producers; ++p) {
+    threads.emplace_back([&]() {
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      for (std::size_t i = 0; i < per_producer; ++i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push(i);
+      }
+    });
+  }
+
+  Clock::time_point begin = Clock::now();
+  start.store(true, std::memory_order_release);
+
+  for (std::size_t received = 0; received < producers * per_producer;) {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!queue.empty()) {
+      queue.pop();
+      ++received;
+    }
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  return producers * per_producer / seconds;
+}
+
+int main() {
+  const unsigned hardware_threads = std::max(2u, std::thread::hardware_concurrency());
+  const std::size_t messages = 4'000'000;
+
+  std::cout << "SPSC (M messages/s, 0 means the order was wrong):\n"
+            << "    one by one: " << spsc_run(messages, false) / 1e6 << "\n"
+            << "    batches of " << batch_size << ": " << spsc_run(messages, true) / 1e6 << "\n\n";
+
+  std::cout << "MPSC (M messages/s, 0 means the order was wrong):\n";
+  for (unsigned producers = 1; producers <= hardware_threads; producers *= 2) {
+    std::size_t per_producer = messages / producers;
+    std::cout << "    " << producers << " producer(s): "
+              << "one by one " << mpsc_run(producers, per_producer, false) / 1e6
+              << ", batches of " << batch_size << " " << mpsc_run(producers, per_producer, true) / 1e6
+              << ", mutex + std::queue " << mutex_run(producers, per_producer) / 1e6 << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+// Lock-free LIFO stack (Treiber stack) for many producers and consumers.
+//
+// The linked representation of a stack from the seminar keeps a pointer to
+// the top node. Here the top is changed with compare-and-swap, so several
+// threads can push and pop at the same time without a mutex.
+//
+// The nodes come from a pool allocated once in the constructor: push()
+// takes a node from a free list and pop returns it there, so the hot path
+// never calls new or delete. Since nodes are never given back to the
+// system, a thread that still looks at a popped node reads valid memory.
+//
+// ABA problem: thread 1 reads top = A (next = B) and is paused; thread 2
+// pops A and B and pushes A back. The top is A again, so thread 1's CAS
+// succeeds and installs B, which is no longer in the stack. To prevent
+// this the top holds a node index together with a counter (tag) which is
+// incremented on every change, so the CAS fails if anything happened in
+// between. The free list is a stack of the same kind.
+//
+// T must be default constructible and move assignable.
+template <typename T>
+class LockFreeStack {
+private:
+  using index_type = std::uint32_t;
+  static constexpr index_type null_index = UINT32_MAX;
+
+  struct Node {
+    T data;
+    std::atomic<index_type> next{null_index};
+  };
+
+  // A node index in the low 32 bits and a tag in the high 32 bits
+  using tagged_index = std::uint64_t;
+
+  static index_type index_of(tagged_index value) {
+    return static_cast<index_type>(value);
+  }
+
+  static tagged_index make_tagged(index_type index, tagged_index old) {
+    tagged_index tag = (old >> 32) + 1;
+    return (tag << 32) | index;
+  }
+
+  // Keeps head and free_head on separate cache lines, so pushes and pops
+  // do not slow down the threads that allocate nodes and vice versa
+  struct alignas(64) AlignedHead {
+    std::atomic<tagged_index> value;
+  };
+
+  std::unique_ptr<Node[]> nodes;
+  std::size_t pool_size;
+  AlignedHead head;
+  AlignedHead free_head;
+
+  // Rejects capacities whose node indices would not fit in index_type,
+  // before anything is allocated for them
+  static std::size_t checked_capacity(std::size_t capacity) {
+    if (capacity >= null_index) {
+      throw std::length_error("LockFreeStack capacity must be less than 2^32 - 1");
+    }
+    return capacity;
+  }
+
+  // Pushes the chain first -> ... -> last onto one of the two stacks
+  void push_chain(AlignedHead& top, index_type first, index_type last) {
+    tagged_index old = top.value.load(std::memory_order_relaxed);
+    tagged_index desired;
+
+    do {
+      nodes[last].next.store(index_of(old), std::memory_order_relaxed);
+      desired = make_tagged(first, old);
+    } while (!top.value.compare_exchange_weak(old, desired, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  // Pops one node from one of the two stacks; null_index if it is empty
+  index_type pop_node(AlignedHead& top) {
+    tagged_index old = top.value.load(std::memory_order_acquire);
+
+    while (index_of(old) != null_index) {
+      // The node may be popped by someone else meanwhile; then the
+      // value read here is stale, but the CAS below fails because of the tag.
+      index_type next = nodes[index_of(old)].next.load(std::memory_order_relaxed);
+
+      if (top.value.compare_exchange_weak(old, make_tagged(next, old), std::memory_order_acquire, std::memory_order_acquire)) {
+        return index_of(old);
+      }
+    }
+
+    return null_index;
+  }
+
+public:
+  // Creates a stack which can hold at most `capacity` elements
+  explicit LockFreeStack(std::size_t capacity) : nodes(new Node[checked_capacity(capacity)]), pool_size(capacity) {
+
+    // Initially every node is in the free list
+    for (std::size_t i = 0; i + 1 < capacity; ++i) {
+      nodes[i].next.store(static_cast<index_type>(i + 1), std::memory_order_relaxed);
+    }
+
+    head.value.store(null_index, std::memory_order_relaxed);
+    free_head.value.store(capacity ? 0 : null_index, std::memory_order_relaxed);
+  }
+
+  LockFreeStack(const LockFreeStack&) = delete;
+  LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+  std::size_t capacity() const {
+    return pool_size;
+  }
+
+  // May be out of date as soon as it returns, if other threads are active
+  bool empty() const {
+    return index_of(head.value.load(std::memory_order_acquire)) == null_index;
+  }
+
+  // Returns false, without blocking, if all nodes of the pool are in use
+  bool push(T value) {
+    index_type node = pop_node(free_head);
+    if (node == null_index) {
+      return false;
+    }
+
+    nodes[node].data = std::move(value);
+    push_chain(head, node, node);
+    return true;
+  }
+
+  // Removes the top element. Returns nothing, without blocking, if the stack is empty.
+  std::optional<T> try_pop() {
+    index_type node = pop_node(head);
+    if (node == null_index) {
+      return std::nullopt;
+    }
+
+    std::optional<T> result(std::move(nodes[node].data));
+    push_chain(free_head, node, node);
+    return result;
+  }
+
+  // Takes all elements with a single atomic operation and passes them to
+  // consume(T&&) from top to bottom. Returns how many there were.
+  template <typename Consumer>
+  std::size_t pop_all(Consumer consume) {
+    tagged_index old = head.value.load(std::memory_order_relaxed);
+    while (!head.value.compare_exchange_weak(old, make_tagged(null_index, old), std::memory_order_acquire, std::memory_order_relaxed)) {
+    }
+
+    index_type first = index_of(old);
+    if (first == null_index) {
+      return 0;
+    }
+
+    // The chain is ours now, nobody else can reach it
+    std::size_t count = 0;
+    index_type last = first;
+
+    for (index_type iter = first; iter != null_index; iter = nodes[iter].next.load(std::memory_order_relaxed)) {
+      consume(std::move(nodes[iter].data));
+      last = iter;
+      ++count;
+    }
+
+    // The whole chain goes back to the free list at once
+    push_chain(free_head, first, last);
+    return count;
+  }
+};
@@ -0,0 +1,112 @@
+// Stress test and throughput measurement for LockFreeStack.
+//
+// Build with optimizations and thread support, e.g.:
+//   g++ -std=c++20 -O2 -pthread lockFreeStackBenchmark.cpp -o lockFreeStackBenchmark
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "lockFreeStack.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// Producers push distinct values, consumers pop them (some one by one,
+// some with pop_all). At the end every value must have been popped exactly once.
+bool stress_test(unsigned producers, unsigned consumers, std::size_t per_producer) {
+  LockFreeStack<std::uint64_t> stack(1024);
+  const std::size_t total = producers * per_producer;
+
+  std::vector<std::atomic<unsigned>> seen(total);
+  std::atomic<std::size_t> consumed{0};
+  std::vector<std::thread> threads;
+
+  for (unsigned p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (std::size_t i = 0; i < per_producer; ++i) {
+        while (!stack.push(p * per_producer + i)) {
+          std::this_thread::yield(); // the pool is full, wait for the consumers
+        }
+      }
+    });
+  }
+
+  for (unsigned c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c]() {
+      auto record = [&](std::uint64_t value) {
+        seen[value].fetch_add(1, std::memory_order_relaxed);
+        consumed.fetch_add(1, std::memory_order_relaxed);
+      };
+
+      while (consumed.load(std::memory_order_relaxed) < total) {
+        if (c % 2 == 0) {
+          if (std::optional<std::uint64_t> value = stack.try_pop()) {
+            record(*value);
+          }
+        } else {
+          stack.pop_all(record);
+        }
+      }
+    });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (std::atomic<unsigned>& count : seen) {
+    if (count.load() != 1) {
+      return false;
+    }
+  }
+
+  return stack.empty();
+}
+
+// Every thread repeatedly pushes and pops. Returns operations per second.
+double throughput(unsigned thread_count, std::size_t operations_per_thread) {
+  LockFreeStack<std::uint64_t> stack(thread_count * 64);
+  std::vector<std::thread> threads;
+  std::atomic<bool> start{false};
+
+  for (unsigned t = 0; t < thread_count; ++t) {
+    threads.emplace_back([&, t]() {
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      for (std::size_t i = 0; i < operations_per_thread / 2; ++i) {
+        stack.push(t);
+        stack.try_pop();
+      }
+    });
+  }
+
+  Clock::time_point begin = Clock::now();
+  start.store(true, std::memory_order_release);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  return thread_count * operations_per_thread / seconds;
+}
+
+int main() {
+  const unsigned hardware_threads = std::max(2u, std::thread::hardware_concurrency());
+
+  std::cout << "Stress test (4 producers, 4 consumers): "
+            << (stress_test(4, 4, 200'000) ? "passed" : "FAILED") << "\n";
+  std::cout << "Stress test (" << hardware_threads << " producers, 1 consumer): "
+            << (stress_test(hardware_threads, 1, 100'000) ? "passed" : "FAILED") << "\n\n";
+
+  std::cout << "Throughput (push + pop pairs):\n";
+  for (unsigned threads = 1; threads <= hardware_threads; threads *= 2) {
+    std::cout << "    " << threads << " thread(s): "
+              << throughput(threads, 2'000'000) / 1e6 << " M ops/s\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <utility>
+
+// Ordered set implemented as a skip list.
+//
+// The bottom level is a doubly linked list like DoublyLinkedList, so the
+// elements can be walked in order in both directions. On top of it every
+// node has a random number of "express lane" links that skip over other
+// nodes, which makes search, insertion and removal O(log n) on average
+// instead of the linear scan of DoublyLinkedList.
+//
+// A node and its array of forward links (its "tower") are allocated as one
+// block, with the tower right after the node, so following a link touches
+// a single allocation.
+template <typename T, typename Compare = std::less<T>>
+class SkipList {
+private:
+  static constexpr int max_height = 32;
+
+  struct Node {
+    T data;
+    Node* prev;
+    int height;
+
+    Node(const T& data, int height) : data(data), prev(nullptr), height(height) {}
+
+    // The forward links are stored right after the node, in the same block
+    Node** tower() {
+      return reinterpret_cast<Node**>(this + 1);
+    }
+
+    Node* next() {
+      return tower()[0];
+    }
+
+    static Node* create(const T& data, int height) {
+      void* block = ::operator new(sizeof(Node) + height * sizeof(Node*));
+      Node* node;
+      try {
+        node = new (block) Node(data, height);
+      } catch (...) {
+        ::operator delete(block);
+        throw;
+      }
+
+      for (int i = 0; i < height; ++i) {
+        node->tower()[i] = nullptr;
+      }
+      return node;
+    }
+
+    static void destroy(Node* node) {
+      node->~Node();
+      ::operator delete(node);
+    }
+  };
+
+  static_assert(sizeof(Node) % alignof(Node*) == 0, "The tower must be aligned");
+
+public:
+  class Iterator {
+  public:
+    bool operator!=(const Iterator& other) const {
+      return current != other.current;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return !(*this != other);
+    }
+
+    Iterator& operator++() {
+      current = current->next();
+      return *this;
+    }
+
+    // Decrementing end() gives the last element
+    Iterator& operator--() {
+      current = current ? current->prev : list->last;
+      return *this;
+    }
+
+    const T& operator*() const {
+      return current->data;
+    }
+
+  private:
+    friend class SkipList;
+
+    Iterator(const SkipList* list, Node* current) : list(list), current(current) {}
+
+    const SkipList* list;
+    Node* current;
+  };
+
+  SkipList(const Compare& less = Compare()) : less(less) {
+    clear_links();
+  }
+
+  SkipList(const SkipList& other) : SkipList(other.less) {
+    // The values come in order, so each one is linked after the
+    // current last node of every level it reaches
+    Node** tails[max_height];
+    for (int i = 0; i < max_height; ++i) {
+      tails[i] = &head[i];
+    }
+
+    try {
+      for (Node* iter = other.head[0]; iter; iter = iter->next()) {
+        append(iter->data, tails);
+      }
+    } catch (...) {
+      free();
+      throw;
+    }
+  }
+
+  SkipList& operator=(const SkipList& other) {
+    SkipList copy(other);
+    swap(copy);
+
+    return *this;
+  }
+
+  SkipList(SkipList&& other) : SkipList(other.less) {
+    swap(other);
+  }
+
+  SkipList& operator=(SkipList&& other) {
+    SkipList copy(std::move(other));
+    swap(copy);
+
+    return *this;
+  }
+
+  ~SkipList() {
+    free();
+  }
+
+  bool empty() const {
+    return size == 0;
+  }
+
+  std::size_t get_size() const {
+    return size;
+  }
+
+  // Adds value if it is not in the set yet. Returns false if it was already there.
+  bool insert(const T& value) {
+    Node** update[max_height];
+    Node* found = find_predecessors(value, update);
+
+    if (found && !less(value, found->data)) {
+      return false;
+    }
+
+    int node_height = random_height();
+    Node* node = Node::create(value, node_height);
+
+    // Levels above the current height start at the head
+    for (; height < node_height; ++height) {
+      update[height] = &head[height];
+    }
+
+    for (int level = 0; level < node_height; ++level) {
+      node->tower()[level] = *update[level];
+      *update[level] = node;
+    }
+
+    // Fix the backward link of the bottom level
+    node->prev = update[0] == &head[0] ? nullptr : node_of(update[0]);
+    if (node->next()) {
+      node->next()->prev = node;
+    } else {
+      last = node;
+    }
+
+    ++size;
+    return true;
+  }
+
+  // Removes value from the set. Returns false if it was not there.
+  bool erase(const T& value) {
+    Node** update[max_height];
+    Node* found = find_predecessors(value, update);
+
+    if (!found || less(value, found->data)) {
+      return false;
+    }
+
+    for (int level = 0; level < found->height; ++level) {
+      *update[level] = found->tower()[level];
+    }
+
+    if (found->next()) {
+      found->next()->prev = found->prev;
+    } else {
+      last = found->prev;
+    }
+
+    while (height > 0 && !head[height - 1]) {
+      --height;
+    }
+
+    Node::destroy(found);
+    --size;
+    return true;
+  }
+
+  // Iterator to value, or end() if it is not in the set
+  Iterator search(const T& value) const {
+    Node* found = lower_bound_node(value);
+    return Iterator(this, found && !less(value, found->data) ? found : nullptr);
+  }
+
+  bool contains(const T& value) const {
+    return search(value) != end();
+  }
+
+  // The first element which is not less than value.
+  // The elements in [a, b) are [lower_bound(a), lower_bound(b)).
+  Iterator lower_bound(const T& value) const {
+    return Iterator(this, lower_bound_node(value));
+  }
+
+  // The first element which is greater than value
+  Iterator upper_bound(const T& value) const {
+    Node* node = lower_bound_node(value);
+    if (node && !less(value, node->data)) {
+      node = node->next();
+    }
+    return Iterator(this, node);
+  }
+
+  Iterator begin() const {
+    return Iterator(this, head[0]);
+  }
+
+  Iterator end() const {
+    return Iterator(this, nullptr);
+  }
+
+  Iterator last_i() const {
+    return Iterator(this, last);
+  }
+
+private:
+  // head[i] is the first node on level i
+  Node* head[max_height];
+  Node* last = nullptr;
+  int height = 0;
+  std::size_t size = 0;
+  std::uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+  Compare less;
+
+  void clear_links() {
+    for (int i = 0; i < max_height; ++i) {
+      head[i] = nullptr;
+    }
+    last = nullptr;
+    height = 0;
+    size = 0;
+  }
+
+  void free() {
+    Node* iter = head[0];
+    while (iter) {
+      Node* next = iter->next();
+      Node::destroy(iter);
+      iter = next;
+    }
+    clear_links();
+  }
+
+  void swap(SkipList& other) {
+    std::swap(head, other.head);
+    std::swap(last, other.last);
+    std::swap(height, other.height);
+    std::swap(size, other.size);
+    std::swap(random_state, other.random_state);
+    std::swap(less, other.less);
+  }
+
+  // The node whose tower contains the link `link` (bottom level only)
+  static Node* node_of(Node** link) {
+    return reinterpret_cast<Node*>(link) - 1;
+  }
+
+  // Fills update[i] with the link on level i after which value belongs
+  // and returns the first node which is not less than value
+  Node* find_predecessors(const T& value, Node** (&update)[max_height]) const {
+    Node** links = const_cast<Node**>(head);
+
+    for (int level = height - 1; level >= 0; --level) {
+      while (links[level] && less(links[level]->data, value)) {
+        links = links[level]->tower();
+      }
+      update[level] = &links[level];
+    }
+
+    return height ? *update[0] : nullptr;
+  }
+
+  Node* lower_bound_node(const T& value) const {
+    Node* const* links = head;
+
+    for (int level = height - 1; level >= 0; --level) {
+      while (links[level] && less(links[level]->data, value)) {
+        links = links[level]->tower();
+      }
+    }
+
+    return height ? links[0] : nullptr;
+  }
+
+  // Adds a value greater than all others in the set.
+  // tails[i] is the link after the last node on level i.
+  void append(const T& value, Node** (&tails)[max_height]) {
+    int node_height = random_height();
+    Node* node = Node::create(value, node_height);
+
+    for (int level = 0; level < node_height; ++level) {
+      *tails[level] = node;
+      tails[level] = &node->tower()[level];
+    }
+
+    if (height < node_height) {
+      height = node_height;
+    }
+
+    node->prev = last;
+    last = node;
+    ++size;
+  }
+
+  // Each level is reached with probability 1/4. This gives fewer links per
+  // node (1.33 on average) than the classic 1/2, at the price of a slightly
+  // longer search on each level.
+  int random_height() {
+    // xorshift64
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+
+    int result = 1 + std::countr_zero(random_state | (std::uint64_t(1) << 62)) / 2;
+    return result < max_height ? result : max_height;
+  }
+};
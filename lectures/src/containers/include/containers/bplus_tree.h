@@ -0,0 +1,961 @@
+#pragma once
+
+#include "dynamic_array.h"
+#include "utils/Allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+///
+/// @file
+/// Ordered map stored as a B+-tree
+///
+/// All entries are stored in the leaves, in order, and the leaves are
+/// linked, so a range scan walks through whole arrays of entries instead
+/// of jumping from node to node. The inner nodes hold only keys and child
+/// pointers, so that many of them fit in the cache, and the tree is very
+/// shallow: with the default 256-byte nodes and 64-bit keys every inner
+/// node has 16 children, so a tree of 10^7 entries has only 6 levels.
+///
+/// Each node occupies NodeBytes (a few cache lines) and starts at a cache
+/// line boundary, so searching a node loads only a few lines. The search
+/// within a node counts the keys less than the searched one, which for
+/// arithmetic keys is done without branches. 32-bit and 64-bit signed keys
+/// are compared with SSE2 instructions, which every x86-64 target has.
+/// SSE2 has no 64-bit comparison, so it is put together from 32-bit ones;
+/// when the target enables SSE4.2 (e.g. -msse4.2 or -march=native), the
+/// single SSE4.2 instruction is used instead.
+///
+
+namespace dsa {
+
+namespace bplus_tree_detail {
+
+inline constexpr size_t cache_line_size = 64;
+
+/// Keys compared with < can be searched with SIMD instructions
+template <typename Key, typename Compare>
+inline constexpr bool uses_natural_order =
+    std::is_arithmetic_v<Key> &&
+    (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>);
+
+#if defined(__SSE2__)
+/// Compares the signed 64-bit lanes: all bits of a lane are set where a > b
+inline __m128i greater_epi64(__m128i a, __m128i b)
+{
+#if defined(__SSE4_2__)
+    return _mm_cmpgt_epi64(a, b);
+#else
+    // Flipping the sign bit of the low halves makes their signed comparison unsigned
+    const __m128i flipLow = _mm_set_epi32(0, INT32_MIN, 0, INT32_MIN);
+    a = _mm_xor_si128(a, flipLow);
+    b = _mm_xor_si128(b, flipLow);
+
+    __m128i greater = _mm_cmpgt_epi32(a, b);
+    __m128i equal = _mm_cmpeq_epi32(a, b);
+
+    // a > b if the high half is greater, or equal with a greater low half
+    __m128i greaterHigh = _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128i equalHigh = _mm_shuffle_epi32(equal, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128i greaterLow = _mm_shuffle_epi32(greater, _MM_SHUFFLE(2, 2, 0, 0));
+
+    return _mm_or_si128(greaterHigh, _mm_and_si128(equalHigh, greaterLow));
+#endif
+}
+#endif
+
+/// The number of keys less than key in the sorted keys[0, count), i.e. the lower bound
+template <typename Key, typename Compare>
+size_t count_less(const Key* keys, size_t count, const Key& key, const Compare& less)
+{
+    if constexpr (uses_natural_order<Key, Compare>) {
+        size_t result = 0;
+        size_t i = 0;
+
+#if defined(__SSE2__)
+        if constexpr (std::is_same_v<Key, int32_t>) {
+            __m128i searched = _mm_set1_epi32(key);
+            for (; i + 4 <= count; i += 4) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+                __m128i isLess = _mm_cmpgt_epi32(searched, block);
+                result += std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(isLess))));
+            }
+        }
+        if constexpr (std::is_same_v<Key, int64_t>) {
+            __m128i searched = _mm_set1_epi64x(key);
+            for (; i + 2 <= count; i += 2) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+                __m128i isLess = greater_epi64(searched, block);
+                result += std::popcount(static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(isLess))));
+            }
+        }
+#endif
+
+        // The rest is counted without branches, which compilers can vectorize too
+        for (; i < count; ++i)
+            result += keys[i] < key;
+
+        return result;
+    }
+    else {
+        return static_cast<size_t>(std::lower_bound(keys, keys + count, key, less) - keys);
+    }
+}
+
+} // namespace bplus_tree_detail
+
+///
+/// @brief Ordered map stored as a B+-tree
+///
+/// The nodes are obtained from Allocator<node type>, which must provide
+/// buy() and release() like the allocators in utils/Allocator.h.
+///
+/// Lookups, insertions and erasures take O(log n) time. Pointers to values
+/// stay valid only until the tree is modified, because the entries move
+/// within and between the leaves.
+///
+template <
+    typename Key,
+    typename Value,
+    typename Compare = std::less<Key>,
+    template <typename> class Allocator = SimpleAllocator,
+    size_t NodeBytes = 256>
+class bplus_tree {
+
+    static constexpr size_t header_bytes = 2 * sizeof(void*);
+
+    static constexpr size_t leaf_capacity =
+        std::max<size_t>(4, (NodeBytes - header_bytes) / (sizeof(Key) + sizeof(Value)));
+
+    static constexpr size_t inner_capacity =
+        std::max<size_t>(4, (NodeBytes - header_bytes) / (sizeof(Key) + sizeof(void*)));
+
+    /// Nodes other than the root never have fewer entries (leaves) or keys (inner nodes)
+    static constexpr size_t min_leaf_count = leaf_capacity / 2;
+    static constexpr size_t min_inner_count = (inner_capacity - 1) / 2;
+
+    /// The tree never has more levels than this (enough for 2^64 entries)
+    static constexpr size_t max_height = 64;
+
+public:
+    struct alignas(bplus_tree_detail::cache_line_size) leaf_node {
+        Key keys[leaf_capacity];
+        Value values[leaf_capacity];
+        leaf_node* next = nullptr;
+        size_t count = 0;
+    };
+
+    /// children[i] holds the keys in [keys[i - 1], keys[i])
+    struct alignas(bplus_tree_detail::cache_line_size) inner_node {
+        Key keys[inner_capacity];
+        void* children[inner_capacity + 1] = {};
+        size_t count = 0; // of keys
+    };
+
+private:
+    void* m_root = nullptr;
+    leaf_node* m_first = nullptr;
+    size_t m_height = 0; // 0 for an empty tree, 1 if the root is a leaf
+    size_t m_size = 0;
+    [[no_unique_address]] Compare m_less;
+    Allocator<leaf_node> m_leafAllocator;
+    Allocator<inner_node> m_innerAllocator;
+
+    /// A step from an inner node to its child
+    struct path_step {
+        inner_node* node;
+        size_t child;
+    };
+
+public:
+    /// Constructs an empty tree
+    bplus_tree() = default;
+
+    bplus_tree(const bplus_tree&) = delete;
+    bplus_tree& operator=(const bplus_tree&) = delete;
+
+    /// Move constructor (takes the allocators along with the nodes)
+    bplus_tree(bplus_tree&& other)
+        : bplus_tree()
+    {
+        swap(other);
+    }
+
+    /// Move assignment (takes the allocators along with the nodes)
+    bplus_tree& operator=(bplus_tree&& other)
+    {
+        assert(this != &other); // self-assignment in move operations is UB
+
+        clear();
+        swap(other);
+        return *this;
+    }
+
+    ~bplus_tree()
+    {
+        clear();
+    }
+
+    /// Number of entries in the tree
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /// Number of levels of nodes (0 for an empty tree)
+    size_t height() const noexcept
+    {
+        return m_height;
+    }
+
+    /// Maximal number of entries in one leaf
+    static constexpr size_t leaf_node_capacity() noexcept
+    {
+        return leaf_capacity;
+    }
+
+    /// Maximal number of keys in one inner node
+    static constexpr size_t inner_node_capacity() noexcept
+    {
+        return inner_capacity;
+    }
+
+    Allocator<leaf_node>& leaf_allocator() noexcept
+    {
+        return m_leafAllocator;
+    }
+
+    Allocator<inner_node>& inner_allocator() noexcept
+    {
+        return m_innerAllocator;
+    }
+
+    /// The value with this key or nullptr
+    Value* find(const Key& key)
+    {
+        return const_cast<Value*>(std::as_const(*this).find(key));
+    }
+
+    /// The value with this key or nullptr
+    const Value* find(const Key& key) const
+    {
+        if (empty())
+            return nullptr;
+
+        const leaf_node* leaf = find_leaf(key);
+        size_t index = count_less(leaf->keys, leaf->count, key);
+
+        return is_key_at(leaf->keys, leaf->count, index, key) ? &leaf->values[index] : nullptr;
+    }
+
+    bool contains(const Key& key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    /// The value with this key
+    /// @exception std::out_of_range If the key is not in the tree
+    Value& at(const Key& key)
+    {
+        return const_cast<Value&>(std::as_const(*this).at(key));
+    }
+
+    /// The value with this key
+    /// @exception std::out_of_range If the key is not in the tree
+    const Value& at(const Key& key) const
+    {
+        const Value* value = find(key);
+        if (!value)
+            throw std::out_of_range("The key is not in the tree");
+
+        return *value;
+    }
+
+    ///
+    /// @brief Inserts the entry if the key is not in the tree yet
+    ///
+    /// All nodes which the insertion needs are allocated before the tree is
+    /// changed, so if the allocator throws, the tree stays as it was.
+    ///
+    /// @return A pointer to the value with this key and whether it was inserted
+    ///
+    std::pair<Value*, bool> insert(const Key& key, const Value& value)
+    {
+        if (empty()) {
+            leaf_node* leaf = m_leafAllocator.buy();
+            leaf->keys[0] = key;
+            leaf->values[0] = value;
+            leaf->count = 1;
+
+            m_root = m_first = leaf;
+            m_height = 1;
+            m_size = 1;
+
+            return { &leaf->values[0], true };
+        }
+
+        path_step path[max_height];
+        leaf_node* leaf = find_leaf(key, path);
+        size_t index = count_less(leaf->keys, leaf->count, key);
+
+        if (is_key_at(leaf->keys, leaf->count, index, key))
+            return { &leaf->values[index], false };
+
+        // A full leaf splits, and so does every full inner node above it
+        size_t innerPathLength = m_height - 1;
+        size_t splitInnerNodes = 0;
+        bool newRoot = false;
+
+        if (leaf->count == leaf_capacity) {
+            while (splitInnerNodes < innerPathLength &&
+                   path[innerPathLength - 1 - splitInnerNodes].node->count == inner_capacity)
+                ++splitInnerNodes;
+
+            newRoot = splitInnerNodes == innerPathLength;
+        }
+
+        new_nodes nodes(*this, leaf->count == leaf_capacity, splitInnerNodes + newRoot);
+
+        // Insert into the leaf, splitting it if it is full
+        if (leaf->count < leaf_capacity) {
+            insert_into_leaf(leaf, index, key, value);
+            ++m_size;
+            return { &leaf->values[index], true };
+        }
+
+        leaf_node* right = nodes.take_leaf();
+        Value* inserted = split_leaf(leaf, right, index, key, value);
+        ++m_size;
+
+        // Insert the separators into the parents, splitting the full ones
+        Key separator = right->keys[0];
+        void* rightChild = right;
+
+        for (size_t level = innerPathLength; level > 0; --level) {
+            path_step step = path[level - 1];
+
+            if (step.node->count < inner_capacity) {
+                insert_into_inner(step.node, step.child, separator, rightChild);
+                return { inserted, true };
+            }
+
+            inner_node* rightInner = nodes.take_inner();
+            separator = split_inner(step.node, rightInner, step.child, separator, rightChild);
+            rightChild = rightInner;
+        }
+
+        // The root has split
+        inner_node* root = nodes.take_inner();
+        root->keys[0] = separator;
+        root->children[0] = m_root;
+        root->children[1] = rightChild;
+        root->count = 1;
+
+        m_root = root;
+        ++m_height;
+
+        return { inserted, true };
+    }
+
+    /// Inserts the entry or replaces the value of an existing key
+    /// @return true if the key was inserted, false if it existed
+    bool insert_or_assign(const Key& key, const Value& value)
+    {
+        auto [existing, inserted] = insert(key, value);
+
+        if (!inserted)
+            *existing = value;
+
+        return inserted;
+    }
+
+    ///
+    /// @brief Removes the entry with this key
+    ///
+    /// A node which becomes less than half full takes an entry from a
+    /// sibling or is merged with it.
+    ///
+    /// @return true if there was such an entry
+    ///
+    bool erase(const Key& key)
+    {
+        if (empty())
+            return false;
+
+        path_step path[max_height];
+        leaf_node* leaf = find_leaf(key, path);
+        size_t index = count_less(leaf->keys, leaf->count, key);
+
+        if (!is_key_at(leaf->keys, leaf->count, index, key))
+            return false;
+
+        std::move(leaf->keys + index + 1, leaf->keys + leaf->count, leaf->keys + index);
+        std::move(leaf->values + index + 1, leaf->values + leaf->count, leaf->values + index);
+        --leaf->count;
+        --m_size;
+
+        if (m_height == 1) {
+            if (leaf->count == 0)
+                clear();
+            return true;
+        }
+
+        if (leaf->count >= min_leaf_count)
+            return true;
+
+        rebalance_leaf(leaf, path[m_height - 2]);
+
+        // Merges may propagate the underflow up to the root
+        for (size_t level = m_height - 1; level > 1; --level) {
+            inner_node* node = path[level - 1].node;
+            if (node->count >= min_inner_count)
+                break;
+
+            rebalance_inner(node, path[level - 2]);
+        }
+
+        shrink_root();
+        return true;
+    }
+
+    ///
+    /// @brief Replaces the contents of the tree with the entries (keys[i], values[i])
+    ///
+    /// Builds the tree bottom-up in O(n) time: the leaves are filled with
+    /// consecutive entries and every level of inner nodes is built from the
+    /// one below. If the allocator throws, the tree is left empty.
+    ///
+    /// @exception std::invalid_argument If the arrays have different sizes
+    ///            or the keys are not strictly increasing
+    ///
+    void bulk_load(const dynamic_array<Key>& keys, const dynamic_array<Value>& values)
+    {
+        if (keys.size() != values.size())
+            throw std::invalid_argument("The numbers of keys and values differ");
+
+        for (size_t i = 1; i < keys.size(); ++i) {
+            if (!m_less(keys[i - 1], keys[i]))
+                throw std::invalid_argument("The keys are not strictly increasing");
+        }
+
+        clear();
+
+        if (keys.size() == 0)
+            return;
+
+        dynamic_array<void*> level; // the nodes of the level being built
+        dynamic_array<Key> lowestKeys; // the smallest key in the subtree of each node
+
+        try {
+            build_leaves(keys, values, level, lowestKeys);
+            m_height = 1;
+
+            while (level.size() > 1) {
+                build_inner_level(level, lowestKeys);
+                ++m_height;
+            }
+        }
+        catch (...) {
+            release_partial_build(level);
+            throw;
+        }
+
+        m_root = level[0];
+        m_size = keys.size();
+    }
+
+    /// Calls function(key, value) for every entry, in ascending order of the keys
+    template <typename Function>
+    void for_each(Function function) const
+    {
+        for (const leaf_node* leaf = m_first; leaf; leaf = leaf->next) {
+            for (size_t i = 0; i < leaf->count; ++i)
+                function(leaf->keys[i], leaf->values[i]);
+        }
+    }
+
+    /// Calls function(key, value) for every entry with low <= key < high, in ascending order
+    template <typename Function>
+    void for_each_in_range(const Key& low, const Key& high, Function function) const
+    {
+        if (empty())
+            return;
+
+        const leaf_node* leaf = find_leaf(low);
+        size_t i = count_less(leaf->keys, leaf->count, low);
+
+        for (; leaf; leaf = leaf->next, i = 0) {
+            for (; i < leaf->count; ++i) {
+                if (!m_less(leaf->keys[i], high))
+                    return;
+
+                function(leaf->keys[i], leaf->values[i]);
+            }
+        }
+    }
+
+    /// Removes all entries and releases all nodes
+    void clear()
+    {
+        if (m_root)
+            release_subtree(m_root, m_height);
+
+        m_root = nullptr;
+        m_first = nullptr;
+        m_height = 0;
+        m_size = 0;
+    }
+
+    /// Quickly swaps the contents (and the allocators) of this object with that of another
+    void swap(bplus_tree& other)
+    {
+        std::swap(m_root, other.m_root);
+        std::swap(m_first, other.m_first);
+        std::swap(m_height, other.m_height);
+        std::swap(m_size, other.m_size);
+        std::swap(m_less, other.m_less);
+        std::swap(m_leafAllocator, other.m_leafAllocator);
+        std::swap(m_innerAllocator, other.m_innerAllocator);
+    }
+
+private:
+    ///
+    /// Nodes allocated in advance for one insertion. If an allocation
+    /// fails, the ones already allocated are released again.
+    ///
+    class new_nodes {
+        bplus_tree& m_tree;
+        leaf_node* m_leaf = nullptr;
+        inner_node* m_inner[max_height] = {};
+        size_t m_innerCount = 0;
+
+    public:
+        new_nodes(bplus_tree& tree, bool needLeaf, size_t innerCount)
+            : m_tree(tree)
+        {
+            try {
+                if (needLeaf)
+                    m_leaf = m_tree.m_leafAllocator.buy();
+
+                for (; m_innerCount < innerCount; ++m_innerCount)
+                    m_inner[m_innerCount] = m_tree.m_innerAllocator.buy();
+            }
+            catch (...) {
+                release();
+                throw;
+            }
+        }
+
+        new_nodes(const new_nodes&) = delete;
+        new_nodes& operator=(const new_nodes&) = delete;
+
+        ~new_nodes()
+        {
+            release();
+        }
+
+        leaf_node* take_leaf() noexcept
+        {
+            return std::exchange(m_leaf, nullptr);
+        }
+
+        inner_node* take_inner() noexcept
+        {
+            return m_inner[--m_innerCount];
+        }
+
+    private:
+        void release()
+        {
+            if (m_leaf)
+                m_tree.m_leafAllocator.release(m_leaf);
+
+            while (m_innerCount > 0)
+                m_tree.m_innerAllocator.release(m_inner[--m_innerCount]);
+        }
+    };
+
+    size_t count_less(const Key* keys, size_t count, const Key& key) const
+    {
+        return bplus_tree_detail::count_less(keys, count, key, m_less);
+    }
+
+    bool is_key_at(const Key* keys, size_t count, size_t index, const Key& key) const
+    {
+        return index < count && !m_less(key, keys[index]);
+    }
+
+    /// Index of the child whose subtree may contain key
+    size_t child_index(const inner_node* node, const Key& key) const
+    {
+        size_t index = count_less(node->keys, node->count, key);
+        return is_key_at(node->keys, node->count, index, key) ? index + 1 : index;
+    }
+
+    /// The leaf which contains key or where it belongs (the tree must not be empty).
+    /// If path is given, it receives the inner nodes along the way.
+    leaf_node* find_leaf(const Key& key, path_step* path = nullptr) const
+    {
+        void* node = m_root;
+
+        for (size_t level = 1; level < m_height; ++level) {
+            inner_node* inner = static_cast<inner_node*>(node);
+            size_t child = child_index(inner, key);
+
+            if (path)
+                path[level - 1] = { inner, child };
+
+            node = inner->children[child];
+        }
+
+        return static_cast<leaf_node*>(node);
+    }
+
+    static void insert_into_leaf(leaf_node* leaf, size_t index, const Key& key, const Value& value)
+    {
+        std::move_backward(leaf->keys + index, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + index, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+
+        leaf->keys[index] = key;
+        leaf->values[index] = value;
+        ++leaf->count;
+    }
+
+    /// Moves the upper half of the full leaf to right and inserts the entry into one of them
+    /// @return The inserted value
+    static Value* split_leaf(leaf_node* leaf, leaf_node* right, size_t index, const Key& key, const Value& value)
+    {
+        const size_t leftCount = (leaf_capacity + 1) / 2;
+
+        // The left leaf gets leftCount entries in the end, including the new one if it goes there
+        size_t moveFrom = index < leftCount ? leftCount - 1 : leftCount;
+
+        std::move(leaf->keys + moveFrom, leaf->keys + leaf_capacity, right->keys);
+        std::move(leaf->values + moveFrom, leaf->values + leaf_capacity, right->values);
+        right->count = leaf_capacity - moveFrom;
+        leaf->count = moveFrom;
+
+        right->next = leaf->next;
+        leaf->next = right;
+
+        if (index < leftCount) {
+            insert_into_leaf(leaf, index, key, value);
+            return &leaf->values[index];
+        }
+
+        insert_into_leaf(right, index - leftCount, key, value);
+        return &right->values[index - leftCount];
+    }
+
+    /// Inserts separator and the child to its right after the child at index
+    static void insert_into_inner(inner_node* node, size_t index, const Key& separator, void* rightChild)
+    {
+        std::move_backward(node->keys + index, node->keys + node->count, node->keys + node->count + 1);
+        std::move_backward(node->children + index + 1, node->children + node->count + 1, node->children + node->count + 2);
+
+        node->keys[index] = separator;
+        node->children[index + 1] = rightChild;
+        ++node->count;
+    }
+
+    ///
+    /// Splits the full node while inserting separator and rightChild after
+    /// the child at index. The upper half goes to right.
+    /// @return The middle key, which moves up to the parent
+    ///
+    static Key split_inner(inner_node* node, inner_node* right, size_t index, const Key& separator, void* rightChild)
+    {
+        // Merge everything into temporary arrays first; inner nodes split rarely
+        Key keys[inner_capacity + 1];
+        void* children[inner_capacity + 2];
+
+        std::move(node->keys, node->keys + index, keys);
+        keys[index] = separator;
+        std::move(node->keys + index, node->keys + inner_capacity, keys + index + 1);
+
+        std::copy(node->children, node->children + index + 1, children);
+        children[index + 1] = rightChild;
+        std::copy(node->children + index + 1, node->children + inner_capacity + 1, children + index + 2);
+
+        const size_t leftCount = (inner_capacity + 1) / 2;
+        const size_t rightCount = inner_capacity - leftCount;
+
+        std::move(keys, keys + leftCount, node->keys);
+        std::copy(children, children + leftCount + 1, node->children);
+        node->count = leftCount;
+
+        std::move(keys + leftCount + 1, keys + inner_capacity + 1, right->keys);
+        std::copy(children + leftCount + 1, children + inner_capacity + 2, right->children);
+        right->count = rightCount;
+
+        return std::move(keys[leftCount]);
+    }
+
+    /// Fixes the leaf at parent.child which has too few entries
+    void rebalance_leaf(leaf_node* leaf, path_step parent)
+    {
+        inner_node* node = parent.node;
+        size_t child = parent.child;
+
+        if (child > 0) {
+            leaf_node* left = static_cast<leaf_node*>(node->children[child - 1]);
+
+            if (left->count > min_leaf_count) {
+                // Take the last entry of the left sibling
+                insert_into_leaf(leaf, 0, left->keys[left->count - 1], left->values[left->count - 1]);
+                --left->count;
+                node->keys[child - 1] = leaf->keys[0];
+            }
+            else {
+                merge_leaves(left, leaf, node, child - 1);
+            }
+        }
+        else {
+            leaf_node* right = static_cast<leaf_node*>(node->children[child + 1]);
+
+            if (right->count > min_leaf_count) {
+                // Take the first entry of the right sibling
+                leaf->keys[leaf->count] = std::move(right->keys[0]);
+                leaf->values[leaf->count] = std::move(right->values[0]);
+                ++leaf->count;
+
+                std::move(right->keys + 1, right->keys + right->count, right->keys);
+                std::move(right->values + 1, right->values + right->count, right->values);
+                --right->count;
+
+                node->keys[child] = right->keys[0];
+            }
+            else {
+                merge_leaves(leaf, right, node, child);
+            }
+        }
+    }
+
+    /// Moves all entries of right to left and removes right (the child after index) from parent
+    void merge_leaves(leaf_node* left, leaf_node* right, inner_node* parent, size_t index)
+    {
+        std::move(right->keys, right->keys + right->count, left->keys + left->count);
+        std::move(right->values, right->values + right->count, left->values + left->count);
+        left->count += right->count;
+        left->next = right->next;
+
+        remove_from_inner(parent, index);
+        m_leafAllocator.release(right);
+    }
+
+    /// Fixes the inner node at parent.child which has too few keys
+    void rebalance_inner(inner_node* node, path_step parent)
+    {
+        inner_node* above = parent.node;
+        size_t child = parent.child;
+
+        if (child > 0) {
+            inner_node* left = static_cast<inner_node*>(above->children[child - 1]);
+
+            if (left->count > min_inner_count) {
+                // Rotate right: the separator comes down, the last key of left goes up
+                std::move_backward(node->keys, node->keys + node->count, node->keys + node->count + 1);
+                std::move_backward(node->children, node->children + node->count + 1, node->children + node->count + 2);
+
+                node->keys[0] = std::move(above->keys[child - 1]);
+                node->children[0] = left->children[left->count];
+                ++node->count;
+
+                above->keys[child - 1] = std::move(left->keys[left->count - 1]);
+                --left->count;
+            }
+            else {
+                merge_inner(left, node, above, child - 1);
+            }
+        }
+        else {
+            inner_node* right = static_cast<inner_node*>(above->children[child + 1]);
+
+            if (right->count > min_inner_count) {
+                // Rotate left: the separator comes down, the first key of right goes up
+                node->keys[node->count] = std::move(above->keys[child]);
+                node->children[node->count + 1] = right->children[0];
+                ++node->count;
+
+                above->keys[child] = std::move(right->keys[0]);
+                std::move(right->keys + 1, right->keys + right->count, right->keys);
+                std::move(right->children + 1, right->children + right->count + 1, right->children);
+                --right->count;
+            }
+            else {
+                merge_inner(node, right, above, child);
+            }
+        }
+    }
+
+    /// Moves the separator and everything from right to left and removes right from parent
+    void merge_inner(inner_node* left, inner_node* right, inner_node* parent, size_t index)
+    {
+        left->keys[left->count] = std::move(parent->keys[index]);
+        std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+
+        remove_from_inner(parent, index);
+        m_innerAllocator.release(right);
+    }
+
+    /// Removes the key at index and the child after it
+    static void remove_from_inner(inner_node* node, size_t index)
+    {
+        std::move(node->keys + index + 1, node->keys + node->count, node->keys + index);
+        std::copy(node->children + index + 2, node->children + node->count + 1, node->children + index + 1);
+        --node->count;
+    }
+
+    /// An inner root without keys is replaced by its only child
+    void shrink_root()
+    {
+        while (m_height > 1) {
+            inner_node* root = static_cast<inner_node*>(m_root);
+            if (root->count > 0)
+                return;
+
+            m_root = root->children[0];
+            --m_height;
+            m_innerAllocator.release(root);
+        }
+    }
+
+    void release_subtree(void* node, size_t height)
+    {
+        if (height == 1) {
+            m_leafAllocator.release(static_cast<leaf_node*>(node));
+            return;
+        }
+
+        inner_node* inner = static_cast<inner_node*>(node);
+        for (size_t i = 0; i <= inner->count; ++i)
+            release_subtree(inner->children[i], height - 1);
+
+        m_innerAllocator.release(inner);
+    }
+
+    /// Splits count items into as few groups of at most capacity items as possible,
+    /// with sizes differing by at most one, so that no group is less than half full
+    static size_t group_count(size_t count, size_t capacity) noexcept
+    {
+        return (count + capacity - 1) / capacity;
+    }
+
+    static size_t group_begin(size_t group, size_t groupCount, size_t count) noexcept
+    {
+        return group * (count / groupCount) + std::min(group, count % groupCount);
+    }
+
+    void build_leaves(const dynamic_array<Key>& keys, const dynamic_array<Value>& values,
+                      dynamic_array<void*>& level, dynamic_array<Key>& lowestKeys)
+    {
+        const size_t count = keys.size();
+        const size_t leafCount = group_count(count, leaf_capacity);
+
+        level.reserve(leafCount);
+        lowestKeys.resize(leafCount);
+
+        leaf_node* previous = nullptr;
+
+        for (size_t i = 0; i < leafCount; ++i) {
+            leaf_node* leaf = m_leafAllocator.buy();
+
+            // Linked right away, so that release_partial_build() can find it
+            if (previous)
+                previous->next = leaf;
+            else
+                m_first = leaf;
+            previous = leaf;
+            level.push_back(leaf);
+
+            size_t begin = group_begin(i, leafCount, count);
+            size_t end = group_begin(i + 1, leafCount, count);
+
+            std::copy(keys.data() + begin, keys.data() + end, leaf->keys);
+            std::copy(values.data() + begin, values.data() + end, leaf->values);
+            leaf->count = end - begin;
+            lowestKeys[i] = keys[begin];
+        }
+    }
+
+    /// Replaces the nodes of level with their parents
+    void build_inner_level(dynamic_array<void*>& level, dynamic_array<Key>& lowestKeys)
+    {
+        const size_t count = level.size();
+        const size_t parentCount = group_count(count, inner_capacity + 1);
+
+        dynamic_array<void*> parents;
+        dynamic_array<Key> parentLowestKeys(parentCount);
+        parents.reserve(parentCount);
+
+        try {
+            for (size_t i = 0; i < parentCount; ++i) {
+                inner_node* parent = m_innerAllocator.buy();
+                parents.push_back(parent);
+
+                size_t begin = group_begin(i, parentCount, count);
+                size_t end = group_begin(i + 1, parentCount, count);
+
+                for (size_t child = begin; child < end; ++child) {
+                    parent->children[child - begin] = level[child];
+                    if (child > begin)
+                        parent->keys[child - begin - 1] = lowestKeys[child];
+                }
+
+                parent->count = end - begin - 1;
+                parentLowestKeys[i] = lowestKeys[begin];
+            }
+        }
+        catch (...) {
+            // The parents built so far own nothing yet, the caller releases the level below
+            for (size_t i = 0; i < parents.size(); ++i)
+                m_innerAllocator.release(static_cast<inner_node*>(parents[i]));
+            throw;
+        }
+
+        level.swap(parents);
+        lowestKeys.swap(parentLowestKeys);
+    }
+
+    /// Releases the nodes of a bulk load which could not be finished
+    void release_partial_build(dynamic_array<void*>& level)
+    {
+        if (m_height == 0) {
+            // Only some leaves exist, linked from m_first
+            for (leaf_node* leaf = m_first; leaf; ) {
+                leaf_node* next = leaf->next;
+                m_leafAllocator.release(leaf);
+                leaf = next;
+            }
+        }
+        else {
+            for (size_t i = 0; i < level.size(); ++i)
+                release_subtree(level[i], m_height);
+        }
+
+        m_first = nullptr;
+        m_height = 0;
+    }
+};
+
+} // namespace
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace dsa {
+
+///
+/// @brief Copies count elements from source to destination
+///
+/// The two ranges must not overlap. Trivially copyable elements are copied
+/// with a single memcpy, others are assigned one by one.
+///
+template <typename T>
+void bulk_copy(const T* source, size_t count, T* destination)
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (count != 0) // memcpy must not be called with null pointers
+            std::memcpy(destination, source, count * sizeof(T));
+    }
+    else {
+        std::copy_n(source, count, destination);
+    }
+}
+
+///
+/// @brief Moves count elements from source to destination
+///
+/// The two ranges must not overlap. Trivially copyable elements are copied
+/// with a single memcpy, others are move-assigned one by one.
+///
+template <typename T>
+void bulk_move(T* source, size_t count, T* destination)
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (count != 0)
+            std::memcpy(destination, source, count * sizeof(T));
+    }
+    else {
+        std::move(source, source + count, destination);
+    }
+}
+
+} // namespace
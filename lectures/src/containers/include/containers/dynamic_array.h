@@ -2,7 +2,10 @@
 
 #include "fixed_size_array.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <stdexcept>
 
 namespace dsa {
 
@@ -162,4 +165,275 @@ private:
     }
 };
 
+///
+/// @brief Bit-packed specialization of dynamic_array for bool
+///
+/// The elements are stored one bit each in 64-bit words, which makes the
+/// array eight times smaller than one with a byte per element. Individual
+/// elements are accessed through a proxy (`reference`). Copying and
+/// comparison work on whole words.
+///
+/// The capacity is always a multiple of 64. Bits past size() are not kept
+/// at any particular value; every operation that exposes them sets them first.
+///
+template <>
+class dynamic_array<bool> {
+
+    using word_type = std::uint64_t;
+    static constexpr size_t bits_per_word = 64;
+
+    fixed_size_array<word_type> m_words;
+    size_t m_used = 0;
+
+public:
+
+    /// Thrown when an operation, that requires the array to have at least one element,
+    /// was performed on an empty array.
+    class EmptyArrayException : public std::logic_error {
+    public:
+        EmptyArrayException()
+            : std::logic_error("Operation was performed on an empty array")
+        {}
+    };
+
+    /// Proxy which represents a single bit of the array
+    class reference {
+        word_type* m_word;
+        word_type m_mask;
+
+    public:
+        reference(word_type* word, word_type mask) noexcept
+            : m_word(word), m_mask(mask)
+        {}
+
+        reference(const reference&) = default;
+
+        operator bool() const noexcept
+        {
+            return (*m_word & m_mask) != 0;
+        }
+
+        reference& operator=(bool value) noexcept
+        {
+            // Branch-free: the mask is cleared and then or-ed with itself or with zero
+            *m_word = (*m_word & ~m_mask) | (-word_type(value) & m_mask);
+            return *this;
+        }
+
+        /// Assigns the value of another bit (not the proxy itself)
+        reference& operator=(const reference& other) noexcept
+        {
+            return *this = bool(other);
+        }
+
+        void flip() noexcept
+        {
+            *m_word ^= m_mask;
+        }
+    };
+
+public:
+    /// Constructs an empty array with zero capacity
+    dynamic_array() = default;
+
+    /// Constructs an array with size equal to initialSize and all elements set to false
+    /// @exception std::bad_alloc Memory allocation failed
+    explicit dynamic_array(size_t initialSize)
+        : m_words(words_for(initialSize)), m_used(initialSize)
+    {
+        fill_words(0, m_words.size(), false);
+    }
+
+    // Copy operations
+    dynamic_array(const dynamic_array&) = default;
+    dynamic_array& operator=(const dynamic_array&) = default;
+
+    // Move constructor
+    dynamic_array(dynamic_array&& other)
+        : m_words(std::move(other.m_words)),
+          m_used(other.m_used)
+    {
+        other.m_used = 0;
+    }
+
+    // Move assignment
+    dynamic_array& operator=(dynamic_array&& other)
+    {
+        assert(this != & other); // self-assignment in move assignment is UB
+
+        m_words = std::move(other.m_words);
+
+        m_used = other.m_used;
+        other.m_used = 0;
+
+        return *this;
+    }
+
+    /// Number of elements stored in the array
+    size_t size() const noexcept {
+        return m_used;
+    }
+
+    /// Number of bits the underlying buffer can hold
+    size_t capacity() const noexcept {
+        return m_words.size() * bits_per_word;
+    }
+
+    /// Retrieve the element at index
+    /// @exception std::out_of_range If the index is out of the bounds of the array
+    reference at(size_t index)
+    {
+        check_index(index);
+        return (*this)[index];
+    }
+
+    /// Retrieve the element at index
+    /// @exception std::out_of_range If the index is out of the bounds of the array
+    bool at(size_t index) const
+    {
+        check_index(index);
+        return (*this)[index];
+    }
+
+    /// Retrieve the element at index
+    reference operator[](size_t index)
+    {
+        return reference(&m_words[index / bits_per_word], mask(index));
+    }
+
+    /// Retrieve the element at index
+    bool operator[](size_t index) const
+    {
+        return (m_words[index / bits_per_word] & mask(index)) != 0;
+    }
+
+    /// Append value to the array
+    void push_back(bool value)
+    {
+        reserve(m_used + 1);
+        (*this)[m_used++] = value;
+    }
+
+    /// Remove the last element from the array
+    void pop_back()
+    {
+        if (m_used == 0)
+            throw EmptyArrayException();
+
+        --m_used;
+    }
+
+    /// Ensure the underlying buffer can hold at least desiredCapacity bits
+    void reserve(size_t desiredCapacity)
+    {
+        if (desiredCapacity <= capacity())
+            return;
+
+        size_t newCapacity = std::max(desiredCapacity, capacity() * 2);
+
+        resize_to(words_for(newCapacity));
+    }
+
+    /// Set the size of the array to a specific value.
+    /// New elements are set to value, a whole word at a time.
+    void resize(size_t desiredSize, bool value = false)
+    {
+        if (desiredSize > m_used) {
+            reserve(desiredSize);
+            fill(m_used, desiredSize, value);
+        }
+
+        m_used = desiredSize;
+    }
+
+    /// If possible, reduce the memory used by the array
+    void shrink_to_fit()
+    {
+        resize_to(words_for(m_used));
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(dynamic_array& other)
+    {
+        m_words.swap(other.m_words);
+        std::swap(m_used, other.m_used);
+    }
+
+    /// Checks whether two arrays have the same size and elements, comparing whole words
+    bool operator==(const dynamic_array& other) const
+    {
+        if (m_used != other.m_used)
+            return false;
+
+        size_t fullWords = m_used / bits_per_word;
+
+        for (size_t i = 0; i < fullWords; ++i) {
+            if (m_words[i] != other.m_words[i])
+                return false;
+        }
+
+        size_t remainingBits = m_used % bits_per_word;
+
+        if (remainingBits == 0)
+            return true;
+
+        word_type lastWordMask = (word_type(1) << remainingBits) - 1;
+
+        return ((m_words[fullWords] ^ other.m_words[fullWords]) & lastWordMask) == 0;
+    }
+
+private:
+    static size_t words_for(size_t bits) noexcept
+    {
+        return (bits + bits_per_word - 1) / bits_per_word;
+    }
+
+    static word_type mask(size_t index) noexcept
+    {
+        return word_type(1) << (index % bits_per_word);
+    }
+
+    void check_index(size_t index) const
+    {
+        if (index >= m_used)
+            throw std::out_of_range("index is out of the bounds of the array");
+    }
+
+    /// Sets all bits in [first, last) to value
+    void fill(size_t first, size_t last, bool value)
+    {
+        // Bits up to the next word boundary
+        for (; first < last && first % bits_per_word != 0; ++first)
+            (*this)[first] = value;
+
+        // Whole words
+        size_t firstWord = first / bits_per_word;
+        size_t lastWord = last / bits_per_word;
+
+        if (firstWord < lastWord) {
+            fill_words(firstWord, lastWord, value);
+            first = lastWord * bits_per_word;
+        }
+
+        // Bits in the last, partially used word
+        for (; first < last; ++first)
+            (*this)[first] = value;
+    }
+
+    void fill_words(size_t firstWord, size_t lastWord, bool value)
+    {
+        word_type pattern = value ? ~word_type(0) : 0;
+
+        for (size_t i = firstWord; i < lastWord; ++i)
+            m_words[i] = pattern;
+    }
+
+    void resize_to(size_t desiredWords)
+    {
+        fixed_size_array<word_type> buffer(desiredWords);
+        buffer.fill_from(m_words);
+        m_words = std::move(buffer);
+    }
+};
+
 } // namespace
@@ -0,0 +1,791 @@
+#pragma once
+
+#include "fixed_size_array.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) && !defined(DSA_FLAT_HASH_PORTABLE)
+#include <emmintrin.h>
+#define DSA_FLAT_HASH_SSE2 1
+#endif
+
+///
+/// @file
+/// Hash map and set with open addressing in the style of Swiss tables
+///
+/// The entries are stored directly in one array of slots (no nodes), next
+/// to an array of one-byte control values, one per slot: either "empty" or
+/// 7 bits of the hash of the key stored in the slot. A lookup compares the
+/// control bytes of a whole group of slots (16 with SSE2, 8 otherwise) with
+/// the 7 bits of the hash at once and compares the keys only for the few
+/// slots that match, usually just the right one.
+///
+/// The probing is linear: a key is stored in the first empty slot at or
+/// after its home slot, and a lookup can stop at the first group which
+/// contains an empty slot. Erasing shifts the following entries back
+/// instead of leaving a "deleted" marker (tombstone), so the table never
+/// fills up with tombstones and lookups never get slower after erasures.
+///
+/// Define DSA_FLAT_HASH_PORTABLE to use the portable groups even where
+/// SSE2 is available.
+///
+
+namespace dsa {
+
+namespace flat_hash_detail {
+
+using control_t = int8_t;
+
+/// Control value of an empty slot. Full slots have values 0-127,
+/// so the highest bit alone tells whether a slot is empty.
+inline constexpr control_t empty = static_cast<control_t>(-128);
+
+/// Indices of set bits in a match mask, from the lowest one
+template <typename Mask, unsigned Shift>
+class match_bits {
+    Mask m_bits;
+
+public:
+    explicit match_bits(Mask bits) noexcept
+        : m_bits(bits)
+    {}
+
+    explicit operator bool() const noexcept
+    {
+        return m_bits != 0;
+    }
+
+    /// Index of the lowest set bit, which is then cleared
+    size_t next() noexcept
+    {
+        size_t index = static_cast<size_t>(std::countr_zero(m_bits)) >> Shift;
+        m_bits &= m_bits - 1;
+        return index;
+    }
+};
+
+#ifdef DSA_FLAT_HASH_SSE2
+
+/// Group of 16 control bytes compared with SSE2 instructions
+class group {
+    __m128i m_control;
+
+public:
+    static constexpr size_t width = 16;
+
+    explicit group(const control_t* control) noexcept
+        : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+    {}
+
+    /// The slots whose control byte equals hash
+    match_bits<uint32_t, 0> match(control_t hash) const noexcept
+    {
+        __m128i equal = _mm_cmpeq_epi8(_mm_set1_epi8(hash), m_control);
+        return match_bits<uint32_t, 0>(static_cast<uint32_t>(_mm_movemask_epi8(equal)));
+    }
+
+    /// The empty slots
+    match_bits<uint32_t, 0> match_empty() const noexcept
+    {
+        return match_bits<uint32_t, 0>(static_cast<uint32_t>(_mm_movemask_epi8(m_control)));
+    }
+};
+
+#else
+
+/// Group of 8 control bytes compared as one 64-bit word ("SIMD within a register")
+class group {
+    static constexpr uint64_t lowest_bits = 0x0101010101010101ULL;
+    static constexpr uint64_t highest_bits = 0x8080808080808080ULL;
+
+    uint64_t m_control;
+
+public:
+    static constexpr size_t width = 8;
+
+    explicit group(const control_t* control) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(&m_control, control, sizeof(m_control));
+        }
+        else {
+            m_control = 0;
+            for (size_t i = 0; i < width; ++i)
+                m_control |= uint64_t(static_cast<uint8_t>(control[i])) << (8 * i);
+        }
+    }
+
+    ///
+    /// The slots whose control byte equals hash
+    ///
+    /// Bytes equal to hash become zero after the xor and the subtraction
+    /// then sets their highest bit. A borrow can also set it for a byte
+    /// above a zero one, so there may be false positives, but then the
+    /// key comparison fails.
+    ///
+    match_bits<uint64_t, 3> match(control_t hash) const noexcept
+    {
+        uint64_t x = m_control ^ (lowest_bits * static_cast<uint8_t>(hash));
+        return match_bits<uint64_t, 3>((x - lowest_bits) & ~x & highest_bits);
+    }
+
+    /// The empty slots
+    match_bits<uint64_t, 3> match_empty() const noexcept
+    {
+        return match_bits<uint64_t, 3>(m_control & highest_bits);
+    }
+};
+
+#endif
+
+/// Hash and KeyEqual accept other types than the key
+template <typename Hash, typename KeyEqual>
+concept transparent = requires {
+    typename Hash::is_transparent;
+    typename KeyEqual::is_transparent;
+};
+
+///
+/// @brief The table shared by flat_hash_map and flat_hash_set
+///
+/// Slot is the stored type (a key-value pair or just a key) and KeyOf
+/// extracts the key from it. Slots must be default constructible, as the
+/// whole array is allocated at once; free slots hold default values.
+///
+template <typename Key, typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+class table {
+
+    /// Smallest non-zero capacity, so that a group never sees a slot twice
+    static constexpr size_t min_capacity = group::width;
+
+    fixed_size_array<control_t> m_control; // capacity + group::width - 1 bytes
+    fixed_size_array<Slot> m_slots;
+    size_t m_size = 0;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    table() = default;
+
+    table(const table&) = default;
+    table& operator=(const table&) = default;
+
+    table(table&& other) noexcept
+        : m_control(std::move(other.m_control)),
+          m_slots(std::move(other.m_slots)),
+          m_size(other.m_size),
+          m_hash(std::move(other.m_hash)),
+          m_equal(std::move(other.m_equal))
+    {
+        other.m_size = 0;
+    }
+
+    table& operator=(table&& other) noexcept
+    {
+        table moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return m_slots.size();
+    }
+
+    /// Makes room for count entries without rehashing
+    void reserve(size_t count)
+    {
+        size_t needed = capacity_for(count);
+        if (needed > capacity())
+            rehash(needed);
+    }
+
+    /// Index of the slot with this key or npos
+    template <typename Q>
+    size_t find(const Q& key) const
+    {
+        return m_size == 0 ? npos : find(key, hash_of(key));
+    }
+
+    ///
+    /// @brief Finds the slot of key or stores a new entry for it
+    ///
+    /// If the key is not in the table, store(slot) fills an empty slot with
+    /// the entry. Only then is the slot marked as full and counted, so if
+    /// store throws, the table stays without the entry.
+    /// @return The index of the slot and whether the entry was inserted
+    ///
+    template <typename Store>
+    std::pair<size_t, bool> find_or_insert(const Key& key, Store&& store)
+    {
+        size_t hash = hash_of(key);
+
+        size_t index = m_size == 0 ? npos : find(key, hash);
+        if (index != npos)
+            return { index, false };
+
+        if (m_size + 1 > max_load(capacity()))
+            rehash(std::max(min_capacity, capacity() * 2));
+
+        index = first_empty(hash);
+
+        try {
+            store(m_slots[index]);
+        }
+        catch (...) {
+            m_slots[index] = Slot(); // free slots hold default values
+            throw;
+        }
+
+        set_control(index, fingerprint_of(hash));
+        ++m_size;
+
+        return { index, true };
+    }
+
+    Slot& slot(size_t index) noexcept
+    {
+        return m_slots[index];
+    }
+
+    const Slot& slot(size_t index) const noexcept
+    {
+        return m_slots[index];
+    }
+
+    ///
+    /// @brief Empties the slot at index
+    ///
+    /// The following entries up to the next empty slot are moved back
+    /// where possible, so that no entry is separated from its home slot
+    /// by an empty one.
+    ///
+    void erase_at(size_t index)
+    {
+        size_t mask = capacity() - 1;
+        size_t hole = index;
+
+        set_control(hole, empty);
+
+        for (size_t next = (hole + 1) & mask; m_control[next] != empty; next = (next + 1) & mask) {
+            size_t home = home_of(hash_of(KeyOf()(m_slots[next])));
+
+            // The entry may move to the hole only if the hole is not before its home slot
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                m_slots[hole] = std::move(m_slots[next]);
+                set_control(hole, m_control[next]);
+                set_control(next, empty);
+                hole = next;
+            }
+        }
+
+        m_slots[hole] = Slot();
+        --m_size;
+    }
+
+    /// Removes all entries but keeps the capacity
+    void clear()
+    {
+        for (size_t i = 0; i < capacity(); ++i) {
+            if (m_control[i] != empty)
+                m_slots[i] = Slot();
+        }
+
+        fill_empty(m_control);
+        m_size = 0;
+    }
+
+    /// Calls function(slot) for every full slot
+    template <typename Function>
+    void for_each(Function&& function) const
+    {
+        for (size_t i = 0; i < capacity(); ++i) {
+            if (m_control[i] != empty)
+                function(m_slots[i]);
+        }
+    }
+
+    /// Calls function(slot) for every full slot
+    template <typename Function>
+    void for_each(Function&& function)
+    {
+        for (size_t i = 0; i < capacity(); ++i) {
+            if (m_control[i] != empty)
+                function(m_slots[i]);
+        }
+    }
+
+    void swap(table& other) noexcept
+    {
+        m_control.swap(other.m_control);
+        m_slots.swap(other.m_slots);
+        std::swap(m_size, other.m_size);
+        std::swap(m_hash, other.m_hash);
+        std::swap(m_equal, other.m_equal);
+    }
+
+private:
+    /// Index of the slot with this key or npos, for a non-empty table
+    template <typename Q>
+    size_t find(const Q& key, size_t hash) const
+    {
+        control_t fingerprint = fingerprint_of(hash);
+        size_t mask = capacity() - 1;
+
+        for (size_t position = home_of(hash); ; position = (position + group::width) & mask) {
+            group g(&m_control[position]);
+
+            for (auto matches = g.match(fingerprint); matches; ) {
+                size_t index = (position + matches.next()) & mask;
+                if (m_equal(KeyOf()(m_slots[index]), key))
+                    return index;
+            }
+
+            if (g.match_empty())
+                return npos;
+        }
+    }
+
+    /// At most 3/4 of the slots are used, which keeps the runs of full slots short
+    static size_t max_load(size_t capacity) noexcept
+    {
+        return capacity - capacity / 4;
+    }
+
+    static size_t capacity_for(size_t count) noexcept
+    {
+        if (count == 0)
+            return 0;
+
+        size_t capacity = min_capacity;
+        while (max_load(capacity) < count)
+            capacity *= 2;
+
+        return capacity;
+    }
+
+    /// Spreads the bits of the hash, because e.g. std::hash of an integer
+    /// is the integer itself and its high bits are often all zero
+    template <typename Q>
+    size_t hash_of(const Q& key) const
+    {
+        uint64_t hash = static_cast<uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+
+    /// The lowest 7 bits are stored in the control byte...
+    static control_t fingerprint_of(size_t hash) noexcept
+    {
+        return static_cast<control_t>(hash & 0x7F);
+    }
+
+    /// ...and the others choose the home slot
+    size_t home_of(size_t hash) const noexcept
+    {
+        return (hash >> 7) & (capacity() - 1);
+    }
+
+    size_t first_empty(size_t hash) const
+    {
+        size_t mask = capacity() - 1;
+
+        for (size_t position = home_of(hash); ; position = (position + group::width) & mask) {
+            auto empties = group(&m_control[position]).match_empty();
+            if (empties)
+                return (position + empties.next()) & mask;
+        }
+    }
+
+    /// The bytes after the last slot repeat the first ones, so that a group
+    /// can be loaded from any position without wrapping around
+    void set_control(size_t index, control_t value) noexcept
+    {
+        m_control[index] = value;
+        if (index < group::width - 1)
+            m_control[capacity() + index] = value;
+    }
+
+    static void fill_empty(fixed_size_array<control_t>& control) noexcept
+    {
+        if (control.size() > 0)
+            std::memset(control.data(), static_cast<uint8_t>(empty), control.size());
+    }
+
+    void rehash(size_t newCapacity)
+    {
+        fixed_size_array<control_t> control(newCapacity + group::width - 1);
+        fixed_size_array<Slot> slots(newCapacity);
+        fill_empty(control);
+
+        // After the swap, control and slots hold the old arrays
+        m_control.swap(control);
+        m_slots.swap(slots);
+
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (control[i] == empty)
+                continue;
+
+            size_t hash = hash_of(KeyOf()(slots[i]));
+            size_t index = first_empty(hash);
+            set_control(index, fingerprint_of(hash));
+            m_slots[index] = std::move(slots[i]);
+        }
+    }
+};
+
+struct pair_key {
+    template <typename Pair>
+    const auto& operator()(const Pair& pair) const noexcept
+    {
+        return pair.first;
+    }
+};
+
+struct identity_key {
+    template <typename Key>
+    const Key& operator()(const Key& key) const noexcept
+    {
+        return key;
+    }
+};
+
+} // namespace flat_hash_detail
+
+///
+/// @brief Unordered map with open addressing
+///
+/// Lookups, insertions and erasures take O(1) expected time. Any insertion
+/// or erasure may move the other entries, so pointers returned by find()
+/// stay valid only until the map is modified.
+///
+/// If both Hash and KeyEqual define is_transparent, the lookup functions
+/// accept any type they can hash and compare with Key, e.g. a
+/// std::string_view for std::string keys, without creating a Key.
+///
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map {
+
+    using table_type = flat_hash_detail::table<Key, std::pair<Key, Value>, flat_hash_detail::pair_key, Hash, KeyEqual>;
+
+    table_type m_table;
+
+    static constexpr bool is_transparent = flat_hash_detail::transparent<Hash, KeyEqual>;
+
+public:
+    /// Constructs an empty map with zero capacity
+    flat_hash_map() = default;
+
+    /// Number of entries in the map
+    size_t size() const noexcept
+    {
+        return m_table.size();
+    }
+
+    /// Number of slots (the map rehashes when 3/4 of them are used)
+    size_t capacity() const noexcept
+    {
+        return m_table.capacity();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /// Makes room for count entries, so that inserting them does not rehash
+    void reserve(size_t count)
+    {
+        m_table.reserve(count);
+    }
+
+    ///
+    /// @brief Inserts the entry if the key is not in the map yet
+    ///
+    /// @return A pointer to the value with this key and whether it was inserted
+    ///
+    std::pair<Value*, bool> insert(const Key& key, const Value& value)
+    {
+        auto [index, inserted] = m_table.find_or_insert(key, [&](std::pair<Key, Value>& entry) {
+            entry.first = key;
+            entry.second = value;
+        });
+
+        return { &m_table.slot(index).second, inserted };
+    }
+
+    /// Inserts the entry or replaces the value of an existing key
+    /// @return true if the key was inserted, false if it existed
+    bool insert_or_assign(const Key& key, const Value& value)
+    {
+        auto [index, inserted] = m_table.find_or_insert(key, [&](std::pair<Key, Value>& entry) {
+            entry.first = key;
+            entry.second = value;
+        });
+
+        if (!inserted)
+            m_table.slot(index).second = value;
+
+        return inserted;
+    }
+
+    /// The value with this key, inserted with a default value if it does not exist
+    Value& operator[](const Key& key)
+    {
+        // The value in a free slot is already a default one
+        size_t index = m_table.find_or_insert(key, [&](std::pair<Key, Value>& entry) {
+            entry.first = key;
+        }).first;
+
+        return m_table.slot(index).second;
+    }
+
+    /// The value with this key or nullptr
+    Value* find(const Key& key)
+    {
+        return value_at(m_table.find(key));
+    }
+
+    /// The value with this key or nullptr
+    const Value* find(const Key& key) const
+    {
+        return value_at(m_table.find(key));
+    }
+
+    /// The value with this key or nullptr
+    template <typename Q> requires is_transparent
+    Value* find(const Q& key)
+    {
+        return value_at(m_table.find(key));
+    }
+
+    /// The value with this key or nullptr
+    template <typename Q> requires is_transparent
+    const Value* find(const Q& key) const
+    {
+        return value_at(m_table.find(key));
+    }
+
+    /// The value with this key
+    /// @exception std::out_of_range If the key is not in the map
+    Value& at(const Key& key)
+    {
+        return checked(value_at(m_table.find(key)));
+    }
+
+    /// The value with this key
+    /// @exception std::out_of_range If the key is not in the map
+    const Value& at(const Key& key) const
+    {
+        return checked(value_at(m_table.find(key)));
+    }
+
+    bool contains(const Key& key) const
+    {
+        return m_table.find(key) != table_type::npos;
+    }
+
+    template <typename Q> requires is_transparent
+    bool contains(const Q& key) const
+    {
+        return m_table.find(key) != table_type::npos;
+    }
+
+    /// Removes the entry with this key
+    /// @return true if there was such an entry
+    bool erase(const Key& key)
+    {
+        return erase_key(key);
+    }
+
+    /// Removes the entry with this key
+    /// @return true if there was such an entry
+    template <typename Q> requires is_transparent
+    bool erase(const Q& key)
+    {
+        return erase_key(key);
+    }
+
+    /// Removes all entries but keeps the capacity
+    void clear()
+    {
+        m_table.clear();
+    }
+
+    /// Calls function(key, value) for every entry, in no particular order
+    template <typename Function>
+    void for_each(Function function)
+    {
+        m_table.for_each([&function](std::pair<Key, Value>& entry) {
+            function(std::as_const(entry.first), entry.second);
+        });
+    }
+
+    /// Calls function(key, value) for every entry, in no particular order
+    template <typename Function>
+    void for_each(Function function) const
+    {
+        m_table.for_each([&function](const std::pair<Key, Value>& entry) {
+            function(entry.first, entry.second);
+        });
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(flat_hash_map& other) noexcept
+    {
+        m_table.swap(other.m_table);
+    }
+
+private:
+    Value* value_at(size_t index)
+    {
+        return index == table_type::npos ? nullptr : &m_table.slot(index).second;
+    }
+
+    const Value* value_at(size_t index) const
+    {
+        return index == table_type::npos ? nullptr : &m_table.slot(index).second;
+    }
+
+    template <typename Q>
+    bool erase_key(const Q& key)
+    {
+        size_t index = m_table.find(key);
+        if (index == table_type::npos)
+            return false;
+
+        m_table.erase_at(index);
+        return true;
+    }
+
+    template <typename V>
+    static V& checked(V* value)
+    {
+        if (!value)
+            throw std::out_of_range("The key is not in the map");
+
+        return *value;
+    }
+};
+
+///
+/// @brief Unordered set with open addressing
+///
+/// The counterpart of flat_hash_map without values. See flat_hash_map for
+/// the details of heterogeneous lookup.
+///
+template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_hash_set {
+
+    using table_type = flat_hash_detail::table<Key, Key, flat_hash_detail::identity_key, Hash, KeyEqual>;
+
+    table_type m_table;
+
+    static constexpr bool is_transparent = flat_hash_detail::transparent<Hash, KeyEqual>;
+
+public:
+    /// Constructs an empty set with zero capacity
+    flat_hash_set() = default;
+
+    /// Number of keys in the set
+    size_t size() const noexcept
+    {
+        return m_table.size();
+    }
+
+    /// Number of slots (the set rehashes when 3/4 of them are used)
+    size_t capacity() const noexcept
+    {
+        return m_table.capacity();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /// Makes room for count keys, so that inserting them does not rehash
+    void reserve(size_t count)
+    {
+        m_table.reserve(count);
+    }
+
+    /// Inserts the key if it is not in the set yet
+    /// @return true if the key was inserted
+    bool insert(const Key& key)
+    {
+        return m_table.find_or_insert(key, [&](Key& slot) { slot = key; }).second;
+    }
+
+    bool contains(const Key& key) const
+    {
+        return m_table.find(key) != table_type::npos;
+    }
+
+    template <typename Q> requires is_transparent
+    bool contains(const Q& key) const
+    {
+        return m_table.find(key) != table_type::npos;
+    }
+
+    /// Removes the key
+    /// @return true if the key was in the set
+    bool erase(const Key& key)
+    {
+        return erase_key(key);
+    }
+
+    /// Removes the key
+    /// @return true if the key was in the set
+    template <typename Q> requires is_transparent
+    bool erase(const Q& key)
+    {
+        return erase_key(key);
+    }
+
+    /// Removes all keys but keeps the capacity
+    void clear()
+    {
+        m_table.clear();
+    }
+
+    /// Calls function(key) for every key, in no particular order
+    template <typename Function>
+    void for_each(Function function) const
+    {
+        m_table.for_each(function);
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(flat_hash_set& other) noexcept
+    {
+        m_table.swap(other.m_table);
+    }
+
+private:
+    template <typename Q>
+    bool erase_key(const Q& key)
+    {
+        size_t index = m_table.find(key);
+        if (index == table_type::npos)
+            return false;
+
+        m_table.erase_at(index);
+        return true;
+    }
+};
+
+} // namespace
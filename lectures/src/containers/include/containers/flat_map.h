@@ -0,0 +1,443 @@
+#pragma once
+
+#include "dynamic_array.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace dsa {
+
+///
+/// @brief Ordered map stored as two sorted arrays, one of keys and one of values
+///
+/// Meant for lookup tables which are built once (or in large batches) and
+/// then mostly read. Compared to a map of linked nodes:
+///
+/// - there is no per-entry allocation and no pointers, so the map needs only
+///   about sizeof(Key) + sizeof(Value) bytes per entry;
+/// - a lookup is a binary search in one contiguous array of keys. The search
+///   is branchless: the comparison only selects the next position (usually
+///   with a conditional move), so there are no mispredicted branches.
+///
+/// Inserting or erasing a single entry has to shift the following entries,
+/// which takes O(n) time. insert_n() inserts a whole batch with one merge
+/// instead, in O(n + k log(n + k)) time for k new entries.
+///
+/// If Compare defines is_transparent, the lookup functions accept any type
+/// which can be compared with Key.
+///
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class flat_map {
+
+    dynamic_array<Key> m_keys;
+    dynamic_array<Value> m_values;
+    [[no_unique_address]] Compare m_less;
+
+    static constexpr bool is_transparent = requires { typename Compare::is_transparent; };
+
+    /// Types accepted by the lookup functions. Without a transparent Compare,
+    /// other types are converted to Key once per lookup.
+    template <typename Q>
+    static constexpr bool is_lookup_key =
+        std::is_same_v<Q, Key> || is_transparent || std::is_constructible_v<Key, const Q&>;
+
+public:
+    /// Constructs an empty map with zero capacity
+    flat_map() = default;
+
+    ///
+    /// @brief Constructs a map of count entries (keys[i], values[i])
+    ///
+    /// The entries are sorted once. If a key repeats, the first entry with
+    /// it is kept, as if the entries were inserted one by one.
+    ///
+    flat_map(const Key* keys, const Value* values, size_t count)
+    {
+        insert_n(keys, values, count);
+    }
+
+    /// Number of entries in the map
+    size_t size() const noexcept
+    {
+        return m_keys.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /// Ensure the underlying arrays have room for at least count entries
+    void reserve(size_t count)
+    {
+        m_keys.reserve(count);
+        m_values.reserve(count);
+    }
+
+    /// The keys in ascending order
+    const dynamic_array<Key>& keys() const noexcept
+    {
+        return m_keys;
+    }
+
+    /// The values in the order of their keys
+    const dynamic_array<Value>& values() const noexcept
+    {
+        return m_values;
+    }
+
+    /// The value of the entry at position index (in the order of the keys)
+    Value& value_at(size_t index)
+    {
+        return m_values[index];
+    }
+
+    /// The value of the entry at position index (in the order of the keys)
+    const Value& value_at(size_t index) const
+    {
+        return m_values[index];
+    }
+
+    /// Position of the first key which is not less than key (size() if there is none)
+    template <typename Q> requires is_lookup_key<Q>
+    size_t lower_bound(const Q& key) const
+    {
+        const auto& searched = lookup_key(key);
+
+        size_t count = size();
+        if (count == 0)
+            return 0;
+
+        const Key* base = m_keys.data();
+
+        // The lower bound always stays within [base, base + count]
+        while (count > 1) {
+            size_t half = count / 2;
+            base = m_less(base[half], searched) ? base + half : base;
+            count -= half;
+        }
+
+        return static_cast<size_t>(base - m_keys.data()) + m_less(*base, searched);
+    }
+
+    /// Position of the key or npos
+    template <typename Q> requires is_lookup_key<Q>
+    size_t index_of(const Q& key) const
+    {
+        const auto& searched = lookup_key(key);
+
+        size_t index = lower_bound(searched);
+        return index < size() && !m_less(searched, m_keys[index]) ? index : npos;
+    }
+
+    /// The value with this key or nullptr
+    template <typename Q> requires is_lookup_key<Q>
+    Value* find(const Q& key)
+    {
+        size_t index = index_of(key);
+        return index == npos ? nullptr : &m_values[index];
+    }
+
+    /// The value with this key or nullptr
+    template <typename Q> requires is_lookup_key<Q>
+    const Value* find(const Q& key) const
+    {
+        size_t index = index_of(key);
+        return index == npos ? nullptr : &m_values[index];
+    }
+
+    template <typename Q> requires is_lookup_key<Q>
+    bool contains(const Q& key) const
+    {
+        return index_of(key) != npos;
+    }
+
+    /// The value with this key
+    /// @exception std::out_of_range If the key is not in the map
+    template <typename Q> requires is_lookup_key<Q>
+    Value& at(const Q& key)
+    {
+        return m_values[checked_index_of(key)];
+    }
+
+    /// The value with this key
+    /// @exception std::out_of_range If the key is not in the map
+    template <typename Q> requires is_lookup_key<Q>
+    const Value& at(const Q& key) const
+    {
+        return m_values[checked_index_of(key)];
+    }
+
+    ///
+    /// @brief Inserts the entry if the key is not in the map yet
+    ///
+    /// @return A pointer to the value with this key and whether it was inserted
+    ///
+    std::pair<Value*, bool> insert(const Key& key, const Value& value)
+    {
+        size_t index = lower_bound(key);
+
+        if (index < size() && !m_less(key, m_keys[index]))
+            return { &m_values[index], false };
+
+        return { &insert_new_at(index, key, value), true };
+    }
+
+    /// Inserts the entry or replaces the value of an existing key
+    /// @return true if the key was inserted, false if it existed
+    bool insert_or_assign(const Key& key, const Value& value)
+    {
+        auto [existing, inserted] = insert(key, value);
+
+        if (!inserted)
+            *existing = value;
+
+        return inserted;
+    }
+
+    /// The value with this key, inserted with a default value if it does not exist
+    Value& operator[](const Key& key)
+    {
+        size_t index = lower_bound(key);
+
+        if (index < size() && !m_less(key, m_keys[index]))
+            return m_values[index];
+
+        return insert_new_at(index, key, Value());
+    }
+
+    ///
+    /// @brief Inserts count entries (keys[i], values[i]) at once
+    ///
+    /// The batch is sorted and then merged with the map from the back, so
+    /// every existing entry moves at most once. Like insert(), the batch
+    /// does not replace the values of keys which are already in the map,
+    /// and of repeated keys in the batch the first one is kept.
+    ///
+    /// If copying or moving an entry throws, the map is left unchanged.
+    ///
+    /// @return The number of inserted entries
+    ///
+    size_t insert_n(const Key* keys, const Value* values, size_t count)
+    {
+        // Positions of the batch entries, sorted by key and without repeated keys
+        dynamic_array<size_t> order(count);
+        for (size_t i = 0; i < count; ++i)
+            order[i] = i;
+
+        std::stable_sort(order.data(), order.data() + count, [this, keys](size_t a, size_t b) {
+            return m_less(keys[a], keys[b]);
+        });
+
+        size_t* uniqueEnd = std::unique(order.data(), order.data() + count, [this, keys](size_t a, size_t b) {
+            return !m_less(keys[a], keys[b]);
+        });
+        size_t batchSize = static_cast<size_t>(uniqueEnd - order.data());
+
+        // Leave out the keys which are already in the map
+        size_t newCount = 0;
+        for (size_t i = 0; i < batchSize; ++i) {
+            if (!contains(keys[order[i]]))
+                order[newCount++] = order[i];
+        }
+
+        // Copy the new entries first, so that if a copy throws the map is not changed yet
+        dynamic_array<Key> newKeys(newCount);
+        dynamic_array<Value> newValues(newCount);
+        for (size_t i = 0; i < newCount; ++i) {
+            newKeys[i] = keys[order[i]];
+            newValues[i] = values[order[i]];
+        }
+
+        size_t oldSize = size();
+
+        if constexpr (std::is_nothrow_move_assignable_v<Key> && std::is_nothrow_move_assignable_v<Value>) {
+            // Once both arrays are reserved, resize() only changes their sizes
+            // and the merge only moves entries, so nothing below can throw
+            m_keys.reserve(oldSize + newCount);
+            m_values.reserve(oldSize + newCount);
+            m_keys.resize(oldSize + newCount);
+            m_values.resize(oldSize + newCount);
+
+            merge_from_back<true>(m_keys, m_values, oldSize, newKeys, newValues);
+        }
+        else {
+            // A move which throws could lose an entry, so the existing entries
+            // are copied into new arrays, which replace the old ones at the end
+            dynamic_array<Key> mergedKeys(oldSize + newCount);
+            dynamic_array<Value> mergedValues(oldSize + newCount);
+
+            size_t leading = merge_from_back<false>(mergedKeys, mergedValues, oldSize, newKeys, newValues);
+            std::copy(m_keys.data(), m_keys.data() + leading, mergedKeys.data());
+            std::copy(m_values.data(), m_values.data() + leading, mergedValues.data());
+
+            m_keys.swap(mergedKeys);
+            m_values.swap(mergedValues);
+        }
+
+        return newCount;
+    }
+
+    /// Removes the entry with this key
+    /// @return true if there was such an entry
+    template <typename Q> requires is_lookup_key<Q>
+    bool erase(const Q& key)
+    {
+        size_t index = index_of(key);
+        if (index == npos)
+            return false;
+
+        erase_at(m_keys, index);
+        erase_at(m_values, index);
+        return true;
+    }
+
+    /// Removes all entries
+    void clear()
+    {
+        m_keys.resize(0);
+        m_values.resize(0);
+    }
+
+    /// Calls function(key, value) for every entry, in ascending order of the keys
+    template <typename Function>
+    void for_each(Function function) const
+    {
+        for (size_t i = 0; i < size(); ++i)
+            function(m_keys[i], m_values[i]);
+    }
+
+    /// Calls function(key, value) for every entry with low <= key < high, in ascending order
+    template <typename Function>
+    void for_each_in_range(const Key& low, const Key& high, Function function) const
+    {
+        for (size_t i = lower_bound(low); i < size() && m_less(m_keys[i], high); ++i)
+            function(m_keys[i], m_values[i]);
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(flat_map& other)
+    {
+        m_keys.swap(other.m_keys);
+        m_values.swap(other.m_values);
+        std::swap(m_less, other.m_less);
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    template <typename Q>
+    decltype(auto) lookup_key(const Q& key) const
+    {
+        if constexpr (std::is_same_v<Q, Key> || is_transparent)
+            return (key);
+        else
+            return Key(key);
+    }
+
+    template <typename Q>
+    size_t checked_index_of(const Q& key) const
+    {
+        size_t index = index_of(key);
+        if (index == npos)
+            throw std::out_of_range("The key is not in the map");
+
+        return index;
+    }
+
+    ///
+    /// @brief Inserts a new entry at position index
+    ///
+    /// Both arrays are grown before anything is inserted, and if copying the
+    /// value fails, the key is taken out again. So an exception leaves the
+    /// map as it was and the keys always match the values.
+    ///
+    Value& insert_new_at(size_t index, const Key& key, const Value& value)
+    {
+        m_keys.reserve(size() + 1);
+        m_values.reserve(size() + 1);
+
+        insert_at(m_keys, index, key);
+
+        try {
+            insert_at(m_values, index, value);
+        }
+        catch (...) {
+            erase_at(m_keys, index);
+            throw;
+        }
+
+        return m_values[index];
+    }
+
+    /// Inserts value at index. If copying the value throws, the array is unchanged.
+    template <typename T>
+    static void insert_at(dynamic_array<T>& arr, size_t index, const T& value)
+    {
+        size_t last = arr.size();
+        arr.resize(last + 1);
+
+        try {
+            arr[last] = value;
+        }
+        catch (...) {
+            arr.pop_back();
+            throw;
+        }
+
+        std::rotate(arr.data() + index, arr.data() + last, arr.data() + last + 1);
+    }
+
+    ///
+    /// @brief Merges the first oldSize entries of the map with the sorted new entries
+    ///
+    /// The merged entries are written from the back into outKeys and outValues,
+    /// which have room for all of them. If InPlace, these are the arrays of
+    /// the map and its entries are moved, otherwise they are copied.
+    ///
+    /// @return The number of leading entries of the map which were not written,
+    ///     because all new entries are greater than them
+    ///
+    template <bool InPlace>
+    size_t merge_from_back(dynamic_array<Key>& outKeys, dynamic_array<Value>& outValues, size_t oldSize,
+                           dynamic_array<Key>& newKeys, dynamic_array<Value>& newValues)
+    {
+        size_t existing = oldSize;
+        size_t out = oldSize + newKeys.size();
+
+        for (size_t batch = newKeys.size(); batch > 0; ) {
+            --out;
+
+            if (existing > 0 && m_less(newKeys[batch - 1], m_keys[existing - 1])) {
+                --existing;
+                if constexpr (InPlace) {
+                    outKeys[out] = std::move(m_keys[existing]);
+                    outValues[out] = std::move(m_values[existing]);
+                }
+                else {
+                    outKeys[out] = m_keys[existing];
+                    outValues[out] = m_values[existing];
+                }
+            }
+            else {
+                --batch;
+                outKeys[out] = std::move(newKeys[batch]);
+                outValues[out] = std::move(newValues[batch]);
+            }
+        }
+
+        return existing;
+    }
+
+    template <typename T>
+    static void erase_at(dynamic_array<T>& arr, size_t index)
+    {
+        std::move(arr.data() + index + 1, arr.data() + arr.size(), arr.data() + index);
+        arr.pop_back();
+    }
+};
+
+} // namespace
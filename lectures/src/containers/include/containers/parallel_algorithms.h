@@ -0,0 +1,322 @@
+#pragma once
+
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+///
+/// @file
+/// Parallel algorithms over contiguous containers
+///
+/// The algorithms work with any container which has data() and size(),
+/// e.g. dsa::fixed_size_array and dsa::dynamic_array. They run on a
+/// thread_pool - thread_pool::shared() unless another one is given.
+///
+/// The work is split into blocks of at least min_grain_size elements, so
+/// that each block does enough work to pay for its scheduling. Small inputs
+/// fit in one block, which is processed directly on the calling thread,
+/// without going through the pool.
+///
+
+namespace dsa {
+
+/// Smallest number of elements processed as one task
+inline constexpr size_t min_grain_size = 2048;
+
+/// A container whose elements are stored contiguously
+template <typename Container>
+concept contiguous_container = requires(Container& c) {
+    { c.data() } -> std::contiguous_iterator;
+    { c.size() } -> std::convertible_to<size_t>;
+};
+
+/// Chooses a grain size for count elements: about 8 blocks per worker,
+/// but not less than min_grain_size elements per block
+inline size_t automatic_grain_size(const thread_pool& pool, size_t count)
+{
+    return std::max(min_grain_size, pool.default_grain_size(count));
+}
+
+namespace parallel_detail {
+
+/// Calls body(blockBegin, blockEnd) for blocks of at most grainSize
+/// elements which cover [0, count). A single block is processed right
+/// here, since handing it to the pool would only make the caller wait.
+template <typename Body>
+void for_each_block(thread_pool& pool, size_t count, size_t grainSize, Body&& body)
+{
+    if (count <= grainSize) {
+        if (count > 0)
+            body(size_t(0), count);
+        return;
+    }
+
+    pool.parallel_for_blocks(0, count, grainSize, body);
+}
+
+} // namespace parallel_detail
+
+/// Calls function(element) for every element of the container
+template <contiguous_container Container, typename Function>
+void parallel_for_each(Container& container, Function function, thread_pool& pool = thread_pool::shared())
+{
+    auto* data = container.data();
+
+    parallel_detail::for_each_block(pool, container.size(), automatic_grain_size(pool, container.size()),
+        [data, &function](size_t blockBegin, size_t blockEnd) {
+            for (size_t i = blockBegin; i < blockEnd; ++i)
+                function(data[i]);
+        });
+}
+
+///
+/// @brief Stores function(input[i]) in output[i] for every element of input
+///
+/// input and output may be the same container.
+/// @exception std::invalid_argument If output is smaller than input
+///
+template <contiguous_container Input, contiguous_container Output, typename Function>
+void parallel_transform(const Input& input, Output& output, Function function, thread_pool& pool = thread_pool::shared())
+{
+    if (output.size() < input.size())
+        throw std::invalid_argument("The output is smaller than the input");
+
+    const auto* source = input.data();
+    auto* destination = output.data();
+
+    parallel_detail::for_each_block(pool, input.size(), automatic_grain_size(pool, input.size()),
+        [source, destination, &function](size_t blockBegin, size_t blockEnd) {
+            for (size_t i = blockBegin; i < blockEnd; ++i)
+                destination[i] = function(source[i]);
+        });
+}
+
+/// How parallel_reduce may group the elements
+enum class reduction_order {
+    /// The blocks depend on the number of threads. For floating-point
+    /// values the result may differ slightly between pools of different size.
+    any,
+
+    /// The blocks depend only on the number of elements, so the result is
+    /// the same on every run and with any number of threads
+    deterministic,
+};
+
+///
+/// @brief Combines init and all elements with op
+///
+/// op must be associative: the elements are combined in order within
+/// blocks and then the block results are combined in order, so the result
+/// is init op x[0] op ... op x[n-1], only grouped differently.
+///
+template <contiguous_container Container, typename T, typename Operation = std::plus<>>
+T parallel_reduce(
+    const Container& container,
+    T init,
+    Operation op = Operation(),
+    reduction_order order = reduction_order::any,
+    thread_pool& pool = thread_pool::shared())
+{
+    const size_t count = container.size();
+    if (count == 0)
+        return init;
+
+    // Fixed number of blocks (at most 256) for the deterministic order
+    const size_t grainSize = order == reduction_order::deterministic
+        ? std::max(min_grain_size, (count + 255) / 256)
+        : automatic_grain_size(pool, count);
+
+    const size_t blockCount = (count + grainSize - 1) / grainSize;
+    const auto* data = container.data();
+
+    // A single block is combined directly with init
+    if (blockCount == 1) {
+        for (size_t i = 0; i < count; ++i)
+            init = op(std::move(init), data[i]);
+        return init;
+    }
+
+    std::vector<std::optional<T>> partials(blockCount);
+
+    pool.parallel_for(0, blockCount, 1, [&](size_t block) {
+        size_t blockBegin = block * grainSize;
+        size_t blockEnd = std::min(count, blockBegin + grainSize);
+
+        T partial = data[blockBegin];
+        for (size_t i = blockBegin + 1; i < blockEnd; ++i)
+            partial = op(std::move(partial), data[i]);
+
+        partials[block].emplace(std::move(partial));
+    });
+
+    for (std::optional<T>& partial : partials)
+        init = op(std::move(init), std::move(*partial));
+
+    return init;
+}
+
+///
+/// @brief Inclusive prefix scan: output[i] = init op input[0] op ... op input[i]
+///
+/// Works in two parallel passes over blocks: the first computes the total
+/// of every block, the second scans each block starting from the combined
+/// totals of the blocks before it. op must be associative.
+/// input and output may be the same container.
+///
+/// @exception std::invalid_argument If output is smaller than input
+///
+template <contiguous_container Input, contiguous_container Output, typename T, typename Operation = std::plus<>>
+void parallel_scan(
+    const Input& input,
+    Output& output,
+    T init,
+    Operation op = Operation(),
+    thread_pool& pool = thread_pool::shared())
+{
+    if (output.size() < input.size())
+        throw std::invalid_argument("The output is smaller than the input");
+
+    const size_t count = input.size();
+    if (count == 0)
+        return;
+
+    const size_t grainSize = automatic_grain_size(pool, count);
+    const size_t blockCount = (count + grainSize - 1) / grainSize;
+    const auto* source = input.data();
+    auto* destination = output.data();
+
+    // A single block needs no second pass
+    if (blockCount == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            init = op(std::move(init), source[i]);
+            destination[i] = init;
+        }
+        return;
+    }
+
+    // Pass 1: the total of every block but the last
+    std::vector<std::optional<T>> offsets(blockCount);
+
+    pool.parallel_for(0, blockCount - 1, 1, [&](size_t block) {
+        size_t blockBegin = block * grainSize;
+        size_t blockEnd = blockBegin + grainSize;
+
+        T total = source[blockBegin];
+        for (size_t i = blockBegin + 1; i < blockEnd; ++i)
+            total = op(std::move(total), source[i]);
+
+        offsets[block + 1].emplace(std::move(total));
+    });
+
+    // The value to start each block from
+    offsets[0].emplace(std::move(init));
+    for (size_t block = 1; block < blockCount; ++block) {
+        T combined = op(*offsets[block - 1], std::move(*offsets[block]));
+        *offsets[block] = std::move(combined);
+    }
+
+    // Pass 2: scan every block from its offset
+    pool.parallel_for(0, blockCount, 1, [&](size_t block) {
+        size_t blockBegin = block * grainSize;
+        size_t blockEnd = std::min(count, blockBegin + grainSize);
+
+        T running = std::move(*offsets[block]);
+        for (size_t i = blockBegin; i < blockEnd; ++i) {
+            running = op(std::move(running), source[i]);
+            destination[i] = running;
+        }
+    });
+}
+
+namespace parallel_sort_detail {
+
+template <typename T, typename Compare>
+void merge(T* left, T* leftEnd, T* right, T* rightEnd, T* out, Compare& less, thread_pool& pool)
+{
+    size_t leftSize = leftEnd - left;
+    size_t rightSize = rightEnd - right;
+
+    if (leftSize + rightSize <= min_grain_size) {
+        std::merge(std::make_move_iterator(left), std::make_move_iterator(leftEnd),
+                   std::make_move_iterator(right), std::make_move_iterator(rightEnd),
+                   out, less);
+        return;
+    }
+
+    // Split the larger half in the middle and the other one at the same value
+    if (leftSize < rightSize) {
+        std::swap(left, right);
+        std::swap(leftEnd, rightEnd);
+        std::swap(leftSize, rightSize);
+    }
+
+    T* leftMiddle = left + leftSize / 2;
+    T* rightMiddle = std::lower_bound(right, rightEnd, *leftMiddle, less);
+    T* outMiddle = out + (leftMiddle - left) + (rightMiddle - right);
+
+    *outMiddle = std::move(*leftMiddle);
+
+    pool.parallel_invoke(
+        [&]() { merge(left, leftMiddle, right, rightMiddle, out, less, pool); },
+        [&]() { merge(leftMiddle + 1, leftEnd, rightMiddle, rightEnd, outMiddle + 1, less, pool); });
+}
+
+/// Sorts data[0, count). The result ends up in buffer if toBuffer is set,
+/// otherwise in data. The halves are sorted into the other array and then
+/// merged into the target, so every level moves the elements only once.
+template <typename T, typename Compare>
+void sort(T* data, T* buffer, size_t count, bool toBuffer, Compare& less, thread_pool& pool)
+{
+    if (count <= min_grain_size) {
+        std::sort(data, data + count, less);
+        if (toBuffer)
+            std::move(data, data + count, buffer);
+        return;
+    }
+
+    size_t middle = count / 2;
+
+    pool.parallel_invoke(
+        [&]() { sort(data, buffer, middle, !toBuffer, less, pool); },
+        [&]() { sort(data + middle, buffer + middle, count - middle, !toBuffer, less, pool); });
+
+    T* source = toBuffer ? data : buffer;
+    T* target = toBuffer ? buffer : data;
+
+    merge(source, source + middle, source + middle, source + count, target, less, pool);
+}
+
+} // namespace parallel_sort_detail
+
+///
+/// @brief Sorts the elements of the container (not stable)
+///
+/// Parallel merge sort: blocks are sorted with std::sort and merged with a
+/// parallel merge. Uses a temporary buffer of the same size as the container.
+///
+template <contiguous_container Container, typename Compare = std::less<>>
+void parallel_sort(Container& container, Compare less = Compare(), thread_pool& pool = thread_pool::shared())
+{
+    using T = std::remove_reference_t<decltype(*container.data())>;
+
+    const size_t count = container.size();
+    T* data = container.data();
+
+    if (count <= min_grain_size) {
+        std::sort(data, data + count, less);
+        return;
+    }
+
+    std::vector<T> buffer(count);
+    pool.parallel_invoke([&]() {
+        parallel_sort_detail::sort(data, buffer.data(), count, false, less, pool);
+    });
+}
+
+} // namespace
@@ -0,0 +1,521 @@
+#pragma once
+
+#include "bulk_copy.h"
+#include "dynamic_array.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+///
+/// @file
+/// Priority queues stored as d-ary heaps in a dynamic_array
+///
+/// In a d-ary heap every node has up to Arity children: the children of
+/// the node at index i are at Arity * i + 1, ..., Arity * i + Arity.
+/// A larger arity makes the tree shallower, so push moves an element
+/// through fewer levels, while pop compares more children per level.
+/// The children of a node are next to each other in memory, so with 4
+/// children of a small type they usually share one cache line and the
+/// extra comparisons are cheap. That makes the 4-ary heap faster than the
+/// binary one for large queues.
+///
+
+namespace dsa {
+
+namespace heap_detail {
+
+template <size_t Arity>
+constexpr size_t parent(size_t index) noexcept
+{
+    return (index - 1) / Arity;
+}
+
+template <size_t Arity>
+constexpr size_t first_child(size_t index) noexcept
+{
+    return Arity * index + 1;
+}
+
+} // namespace heap_detail
+
+///
+/// @brief Max-priority queue stored as a d-ary heap
+///
+/// Like std::priority_queue, top() is the largest element with respect to
+/// less (the first one for which no other element x has less(top, x)).
+/// Use std::greater to get the smallest element on the top.
+///
+/// Elements are moved into a "hole" along the path instead of being
+/// swapped, which halves the number of writes.
+///
+template <typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class priority_queue {
+
+    static_assert(Arity >= 2, "A heap node must have at least two children");
+
+    dynamic_array<T> m_items;
+    Compare m_less;
+
+public:
+
+    /// Thrown when an operation, that requires the queue to have at least one element,
+    /// was performed on an empty queue.
+    class EmptyQueueException : public std::logic_error {
+    public:
+        EmptyQueueException()
+            : std::logic_error("Operation was performed on an empty priority queue")
+        {}
+    };
+
+public:
+    /// Constructs an empty queue with zero capacity
+    explicit priority_queue(Compare less = Compare())
+        : m_less(std::move(less))
+    {}
+
+    /// Constructs a queue from count values in O(count) time
+    priority_queue(const T* values, size_t count, Compare less = Compare())
+        : m_items(count), m_less(std::move(less))
+    {
+        bulk_copy(values, count, m_items.data());
+        make_heap();
+    }
+
+    /// Number of elements in the queue
+    size_t size() const noexcept
+    {
+        return m_items.size();
+    }
+
+    /// Size of the underlying buffer
+    size_t capacity() const noexcept
+    {
+        return m_items.capacity();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /// Ensure the underlying buffer has at least a minimal capacity
+    void reserve(size_t desiredCapacity)
+    {
+        m_items.reserve(desiredCapacity);
+    }
+
+    /// The element with the highest priority
+    /// @exception EmptyQueueException If the queue is empty
+    const T& top() const
+    {
+        check_not_empty();
+        return m_items[0];
+    }
+
+    /// Add value to the queue in O(log n) time
+    void push(const T& value)
+    {
+        m_items.push_back(value);
+        sift_up(size() - 1);
+    }
+
+    ///
+    /// @brief Adds count values at once
+    ///
+    /// When many values are added compared to the size of the queue, the
+    /// heap is rebuilt in O(size() + count) time instead of pushing the
+    /// values one by one in O(count * log(size() + count)).
+    /// The values must not be elements of this queue. If copying a value
+    /// throws, the queue is left as it was.
+    ///
+    void push_n(const T* values, size_t count)
+    {
+        size_t oldSize = size();
+
+        m_items.resize(oldSize + count);
+
+        try {
+            bulk_copy(values, count, m_items.data() + oldSize);
+        }
+        catch (...) {
+            m_items.resize(oldSize);
+            throw;
+        }
+
+        if (count > oldSize / 4) {
+            make_heap();
+        }
+        else {
+            for (size_t i = oldSize; i < size(); ++i)
+                sift_up(i);
+        }
+    }
+
+    /// Remove the element with the highest priority in O(log n) time
+    /// @exception EmptyQueueException If the queue is empty
+    void pop()
+    {
+        check_not_empty();
+
+        T last = std::move(m_items[size() - 1]);
+        m_items.pop_back();
+
+        if (!empty())
+            sift_down(0, std::move(last));
+    }
+
+    ///
+    /// @brief Pushes value and then removes and returns the top element
+    ///
+    /// Faster than push() followed by top() and pop(): if value would be
+    /// the new top, it is returned right away and the heap is not touched,
+    /// otherwise it replaces the top with a single sift down.
+    ///
+    T push_pop(T value)
+    {
+        if (empty() || !m_less(value, m_items[0]))
+            return value;
+
+        T result = std::move(m_items[0]);
+        sift_down(0, std::move(value));
+        return result;
+    }
+
+    /// Remove all elements
+    void clear()
+    {
+        m_items.resize(0);
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(priority_queue& other)
+    {
+        m_items.swap(other.m_items);
+        std::swap(m_less, other.m_less);
+    }
+
+private:
+    void check_not_empty() const
+    {
+        if (empty())
+            throw EmptyQueueException();
+    }
+
+    /// Floyd's heap construction: sifts down every node which has children,
+    /// from the last one to the root. Most nodes are near the bottom and move
+    /// only a few levels, which gives O(n) in total.
+    void make_heap()
+    {
+        if (size() < 2)
+            return;
+
+        for (size_t i = heap_detail::parent<Arity>(size() - 1) + 1; i-- > 0; )
+            sift_down(i, std::move(m_items[i]));
+    }
+
+    void sift_up(size_t index)
+    {
+        T value = std::move(m_items[index]);
+
+        while (index > 0) {
+            size_t parent = heap_detail::parent<Arity>(index);
+            if (!m_less(m_items[parent], value))
+                break;
+
+            m_items[index] = std::move(m_items[parent]);
+            index = parent;
+        }
+
+        m_items[index] = std::move(value);
+    }
+
+    /// Places value into the subtree rooted at the hole at index
+    void sift_down(size_t index, T value)
+    {
+        const size_t count = size();
+
+        while (true) {
+            size_t child = heap_detail::first_child<Arity>(index);
+            if (child >= count)
+                break;
+
+            // The largest of the (up to Arity) children
+            size_t best = child;
+            size_t lastChild = std::min(child + Arity, count);
+            for (++child; child < lastChild; ++child) {
+                if (m_less(m_items[best], m_items[child]))
+                    best = child;
+            }
+
+            if (!m_less(value, m_items[best]))
+                break;
+
+            m_items[index] = std::move(m_items[best]);
+            index = best;
+        }
+
+        m_items[index] = std::move(value);
+    }
+};
+
+///
+/// @brief Priority queue of items identified by indices, with decrease_key
+///
+/// Every item is an index (e.g. a task or a graph vertex) with a priority.
+/// The queue remembers where each index is in the heap, so the priority of
+/// an item which is already queued can be changed in O(log n) time.
+///
+/// By default the item with the smallest priority is on the top, as in
+/// schedulers and shortest path algorithms. In general it is the item with
+/// the largest priority with respect to less, like in priority_queue.
+/// "Decreasing" a key means moving it towards the top.
+///
+/// Each heap entry stores the priority next to the index, so comparisons
+/// do not have to look the priorities up elsewhere.
+///
+template <typename Priority, typename Compare = std::greater<Priority>, size_t Arity = 4>
+class indexed_priority_queue {
+
+    static_assert(Arity >= 2, "A heap node must have at least two children");
+
+    struct entry {
+        Priority priority{};
+        size_t index = 0;
+    };
+
+    static constexpr size_t not_queued = std::numeric_limits<size_t>::max();
+
+    dynamic_array<entry> m_heap;
+    dynamic_array<size_t> m_positions; // index -> position in m_heap or not_queued
+    Compare m_less;
+
+public:
+
+    /// Thrown when an operation, that requires the queue to have at least one element,
+    /// was performed on an empty queue.
+    class EmptyQueueException : public std::logic_error {
+    public:
+        EmptyQueueException()
+            : std::logic_error("Operation was performed on an empty priority queue")
+        {}
+    };
+
+public:
+    /// Constructs an empty queue
+    explicit indexed_priority_queue(Compare less = Compare())
+        : m_less(std::move(less))
+    {}
+
+    /// Number of items in the queue
+    size_t size() const noexcept
+    {
+        return m_heap.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /// Checks whether the item with this index is in the queue
+    bool contains(size_t index) const noexcept
+    {
+        return index < m_positions.size() && m_positions[index] != not_queued;
+    }
+
+    /// The index of the item with the highest priority
+    /// @exception EmptyQueueException If the queue is empty
+    size_t top_index() const
+    {
+        check_not_empty();
+        return m_heap[0].index;
+    }
+
+    /// The highest priority in the queue
+    /// @exception EmptyQueueException If the queue is empty
+    const Priority& top_priority() const
+    {
+        check_not_empty();
+        return m_heap[0].priority;
+    }
+
+    /// The priority of a queued item
+    /// @exception std::out_of_range If the item is not in the queue
+    const Priority& priority(size_t index) const
+    {
+        return m_heap[position_of(index)].priority;
+    }
+
+    /// Add an item with a priority
+    /// @exception std::invalid_argument If the item already is in the queue
+    void push(size_t index, const Priority& priority)
+    {
+        if (contains(index))
+            throw std::invalid_argument("The item already is in the queue");
+
+        if (index >= m_positions.size()) {
+            size_t oldSize = m_positions.size();
+            m_positions.resize(index + 1);
+            for (size_t i = oldSize; i < m_positions.size(); ++i)
+                m_positions[i] = not_queued;
+        }
+
+        m_heap.push_back(entry{ priority, index });
+        sift_up(size() - 1);
+    }
+
+    /// Remove the item with the highest priority and return its index
+    /// @exception EmptyQueueException If the queue is empty
+    size_t pop()
+    {
+        check_not_empty();
+
+        size_t index = m_heap[0].index;
+        remove_at(0);
+        return index;
+    }
+
+    /// Remove an item from the queue
+    /// @exception std::out_of_range If the item is not in the queue
+    void erase(size_t index)
+    {
+        remove_at(position_of(index));
+    }
+
+    ///
+    /// @brief Moves an item towards the top by giving it a higher priority
+    ///
+    /// @exception std::out_of_range If the item is not in the queue
+    /// @exception std::invalid_argument If the new priority is lower than the current one
+    ///
+    void decrease_key(size_t index, const Priority& priority)
+    {
+        size_t position = position_of(index);
+
+        if (m_less(priority, m_heap[position].priority))
+            throw std::invalid_argument("decrease_key() cannot lower the priority");
+
+        m_heap[position].priority = priority;
+        sift_up(position);
+    }
+
+    /// Sets the priority of a queued item, whether higher or lower than the current one
+    /// @exception std::out_of_range If the item is not in the queue
+    void change_priority(size_t index, const Priority& priority)
+    {
+        size_t position = position_of(index);
+        bool higher = m_less(m_heap[position].priority, priority);
+
+        m_heap[position].priority = priority;
+
+        if (higher)
+            sift_up(position);
+        else
+            sift_down(position);
+    }
+
+    /// Remove all items
+    void clear()
+    {
+        for (size_t i = 0; i < size(); ++i)
+            m_positions[m_heap[i].index] = not_queued;
+
+        m_heap.resize(0);
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(indexed_priority_queue& other)
+    {
+        m_heap.swap(other.m_heap);
+        m_positions.swap(other.m_positions);
+        std::swap(m_less, other.m_less);
+    }
+
+private:
+    void check_not_empty() const
+    {
+        if (empty())
+            throw EmptyQueueException();
+    }
+
+    size_t position_of(size_t index) const
+    {
+        if (!contains(index))
+            throw std::out_of_range("The item is not in the queue");
+
+        return m_positions[index];
+    }
+
+    /// Puts the last entry to position and restores the heap
+    void remove_at(size_t position)
+    {
+        m_positions[m_heap[position].index] = not_queued;
+
+        size_t last = size() - 1;
+        if (position != last) {
+            m_heap[position] = std::move(m_heap[last]);
+            m_positions[m_heap[position].index] = position;
+        }
+
+        m_heap.pop_back();
+
+        if (position < size()) {
+            sift_up(position);
+            sift_down(m_positions[m_heap[position].index]);
+        }
+    }
+
+    void place(size_t position, entry&& value)
+    {
+        m_positions[value.index] = position;
+        m_heap[position] = std::move(value);
+    }
+
+    void sift_up(size_t position)
+    {
+        entry value = std::move(m_heap[position]);
+
+        while (position > 0) {
+            size_t parent = heap_detail::parent<Arity>(position);
+            if (!m_less(m_heap[parent].priority, value.priority))
+                break;
+
+            place(position, std::move(m_heap[parent]));
+            position = parent;
+        }
+
+        place(position, std::move(value));
+    }
+
+    void sift_down(size_t position)
+    {
+        const size_t count = size();
+        entry value = std::move(m_heap[position]);
+
+        while (true) {
+            size_t child = heap_detail::first_child<Arity>(position);
+            if (child >= count)
+                break;
+
+            size_t best = child;
+            size_t lastChild = std::min(child + Arity, count);
+            for (++child; child < lastChild; ++child) {
+                if (m_less(m_heap[best].priority, m_heap[child].priority))
+                    best = child;
+            }
+
+            if (!m_less(value.priority, m_heap[best].priority))
+                break;
+
+            place(position, std::move(m_heap[best]));
+            position = best;
+        }
+
+        place(position, std::move(value));
+    }
+};
+
+} // namespace
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "dynamic_array.h"
+#include "fixed_size_array.h"
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+///
+/// @file
+/// LSD (least significant digit first) radix sort for dynamic_array
+///
+/// Instead of comparing elements, the sort looks at the bits of their keys,
+/// DigitBits bits (a "digit") at a time, starting from the lowest ones. Each
+/// pass distributes the elements into 2^DigitBits buckets by one digit,
+/// keeping the order of elements with equal digits (it is stable), so after
+/// the pass for the highest digit the elements are sorted by the whole key.
+/// This takes O(passes * n) time and one scratch buffer of n elements.
+///
+/// Larger digits mean fewer passes but larger histograms: 8 bits (256
+/// buckets) fit in L1 cache, 11 bits sort 64-bit keys in 6 passes instead
+/// of 8, 16 bits suit very large arrays of 32-bit keys.
+///
+
+namespace dsa {
+
+/// Types which radix_sort can use as keys
+template <typename K>
+concept radix_sortable_key =
+    (std::integral<K> && !std::same_as<K, bool>) ||
+    std::same_as<K, float> || std::same_as<K, double>;
+
+namespace radix_sort_detail {
+
+///
+/// Maps a key to an unsigned integer of the same size whose natural order
+/// is the order of the keys:
+///
+/// - signed integers: the sign bit is flipped, so negative numbers come first;
+/// - floating-point numbers: for positive numbers the sign bit is set, for
+///   negative ones all bits are flipped (larger magnitude = smaller number).
+///   This gives -Inf < negative < -0.0 < +0.0 < positive < +Inf.
+///   All NaNs are mapped to the same value after +Inf, so like in
+///   floating-point.cpp's equal() they are all treated as equal to each
+///   other, and they end up together at the end of the array.
+///
+template <radix_sortable_key K>
+auto to_unsigned(K key) noexcept
+{
+    using unsigned_type = std::make_unsigned_t<
+        std::conditional_t<std::is_floating_point_v<K>,
+            std::conditional_t<sizeof(K) == 4, int32_t, int64_t>,
+            K>>;
+
+    constexpr unsigned_type signBit = unsigned_type(1) << (sizeof(K) * 8 - 1);
+
+    if constexpr (std::is_floating_point_v<K>) {
+        if (key != key) // NaN
+            return std::numeric_limits<unsigned_type>::max();
+
+        unsigned_type bits = std::bit_cast<unsigned_type>(key);
+        return (bits & signBit) ? ~bits : (bits | signBit);
+    }
+    else if constexpr (std::is_signed_v<K>) {
+        return static_cast<unsigned_type>(static_cast<unsigned_type>(key) ^ signBit);
+    }
+    else {
+        return key;
+    }
+}
+
+/// Below this many elements a thread pool is not used
+inline constexpr size_t parallel_threshold = 1 << 16;
+
+/// Smallest number of elements of one block in the parallel version
+inline constexpr size_t min_block_size = 1 << 14;
+
+template <unsigned DigitBits, typename T, typename KeyFunction>
+class sorter {
+    using key_type = decltype(to_unsigned(std::declval<KeyFunction&>()(std::declval<const T&>())));
+
+    static constexpr unsigned pass_count = (sizeof(key_type) * 8 + DigitBits - 1) / DigitBits;
+    static constexpr size_t bucket_count = size_t(1) << DigitBits;
+
+    KeyFunction& m_key;
+    thread_pool* m_pool;
+
+public:
+    sorter(KeyFunction& key, thread_pool* pool)
+        : m_key(key), m_pool(pool)
+    {}
+
+    void sort(T* data, size_t count)
+    {
+        if (count < 2)
+            return;
+
+        fixed_size_array<T> buffer(count);
+        T* source = data;
+        T* target = buffer.data();
+
+        size_t blockCount = 1;
+        if (m_pool && count >= parallel_threshold)
+            blockCount = std::min(m_pool->thread_count() * 4, count / min_block_size);
+
+        if (blockCount > 1)
+            sort_parallel(source, target, count, blockCount);
+        else
+            sort_serial(source, target, count);
+
+        // After an odd number of passes the result is in the buffer
+        if (source != data)
+            std::move(source, source + count, data);
+    }
+
+private:
+    size_t digit(const T& value, unsigned pass) const
+    {
+        return static_cast<size_t>(to_unsigned(m_key(value)) >> (pass * DigitBits)) & (bucket_count - 1);
+    }
+
+    /// Moves the elements of source to target, each bucket starting at its offset
+    void scatter(T* source, size_t begin, size_t end, T* target, size_t* offsets, unsigned pass) const
+    {
+        for (size_t i = begin; i < end; ++i)
+            target[offsets[digit(source[i], pass)]++] = std::move(source[i]);
+    }
+
+    /// A pass is trivial when all elements have the same digit, so it would not move anything
+    static bool is_trivial(const size_t* histogram, size_t count)
+    {
+        for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+            if (histogram[bucket] != 0)
+                return histogram[bucket] == count;
+        }
+        return true;
+    }
+
+    void sort_serial(T*& source, T*& target, size_t count)
+    {
+        // The histograms of all digits are computed in a single read pass.
+        // They do not depend on the order of the elements, so they stay valid.
+        std::vector<size_t> histograms(pass_count * bucket_count, 0);
+
+        for (size_t i = 0; i < count; ++i) {
+            key_type key = to_unsigned(m_key(source[i]));
+            for (unsigned pass = 0; pass < pass_count; ++pass)
+                ++histograms[pass * bucket_count + (static_cast<size_t>(key >> (pass * DigitBits)) & (bucket_count - 1))];
+        }
+
+        std::vector<size_t> offsets(bucket_count);
+
+        for (unsigned pass = 0; pass < pass_count; ++pass) {
+            const size_t* histogram = &histograms[pass * bucket_count];
+            if (is_trivial(histogram, count))
+                continue;
+
+            size_t running = 0;
+            for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+                offsets[bucket] = running;
+                running += histogram[bucket];
+            }
+
+            scatter(source, 0, count, target, offsets.data(), pass);
+            std::swap(source, target);
+        }
+    }
+
+    ///
+    /// The array is split into blocks. For every pass each block counts its
+    /// digits, then every (block, bucket) pair gets its own range of the
+    /// target: the buckets in order and within a bucket the blocks in order.
+    /// This keeps the sort stable and lets the blocks scatter in parallel.
+    ///
+    void sort_parallel(T*& source, T*& target, size_t count, size_t blockCount)
+    {
+        size_t blockSize = (count + blockCount - 1) / blockCount;
+        std::vector<size_t> counts(blockCount * bucket_count);
+        std::vector<size_t> totals(bucket_count);
+
+        auto blockBegin = [=](size_t block) { return std::min(count, block * blockSize); };
+
+        for (unsigned pass = 0; pass < pass_count; ++pass) {
+            std::fill(counts.begin(), counts.end(), 0);
+
+            m_pool->parallel_for(0, blockCount, 1, [&](size_t block) {
+                size_t* blockCounts = &counts[block * bucket_count];
+                for (size_t i = blockBegin(block); i < blockBegin(block + 1); ++i)
+                    ++blockCounts[digit(source[i], pass)];
+            });
+
+            std::fill(totals.begin(), totals.end(), 0);
+            for (size_t block = 0; block < blockCount; ++block) {
+                for (size_t bucket = 0; bucket < bucket_count; ++bucket)
+                    totals[bucket] += counts[block * bucket_count + bucket];
+            }
+
+            if (is_trivial(totals.data(), count))
+                continue;
+
+            // Turn the counts into offsets
+            size_t running = 0;
+            for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+                for (size_t block = 0; block < blockCount; ++block) {
+                    size_t& slot = counts[block * bucket_count + bucket];
+                    size_t blockBucketCount = slot;
+                    slot = running;
+                    running += blockBucketCount;
+                }
+            }
+
+            m_pool->parallel_for(0, blockCount, 1, [&](size_t block) {
+                scatter(source, blockBegin(block), blockBegin(block + 1), target, &counts[block * bucket_count], pass);
+            });
+
+            std::swap(source, target);
+        }
+    }
+};
+
+} // namespace radix_sort_detail
+
+///
+/// @brief Sorts the array by key(element) in ascending order (stable)
+///
+/// key must return an integer (other than bool), a float or a double.
+/// If pool is not null and the array is large, the passes are run in parallel.
+///
+template <unsigned DigitBits = 8, typename T, typename KeyFunction>
+    requires std::invocable<KeyFunction&, const T&> &&
+             radix_sortable_key<std::remove_cvref_t<std::invoke_result_t<KeyFunction&, const T&>>>
+void radix_sort(dynamic_array<T>& arr, KeyFunction key, thread_pool* pool = nullptr)
+{
+    static_assert(DigitBits == 8 || DigitBits == 11 || DigitBits == 16, "The digits must have 8, 11 or 16 bits");
+
+    radix_sort_detail::sorter<DigitBits, T, KeyFunction>(key, pool).sort(arr.data(), arr.size());
+}
+
+///
+/// @brief Sorts an array of integers, floats or doubles in ascending order
+///
+/// For floating-point numbers -0.0 comes before +0.0 and all NaNs are put at the end.
+///
+template <unsigned DigitBits = 8, radix_sortable_key T>
+void radix_sort(dynamic_array<T>& arr, thread_pool* pool = nullptr)
+{
+    radix_sort<DigitBits>(arr, std::identity(), pool);
+}
+
+} // namespace
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "bulk_copy.h"
+#include "dynamic_array.h"
+
+#include <stdexcept>
+
+namespace dsa {
+
+///
+/// @brief LIFO stack stored in a dynamic_array
+///
+/// Unlike a stack of linked nodes, pushing an element does not allocate
+/// (except when the buffer has to grow) and the elements are contiguous
+/// in memory. push_n and pop_n transfer a whole span at once, with a single
+/// memcpy for trivially copyable types.
+///
+/// The buffer grows by doubling. It shrinks by half when the stack becomes
+/// a quarter full, not half full: otherwise a push and a pop at the
+/// boundary would reallocate every time (thrashing).
+///
+template <typename T>
+class resizing_stack {
+
+    dynamic_array<T> m_items;
+
+    /// The buffer is never shrunk below this capacity
+    static constexpr size_t min_capacity = 16;
+
+public:
+
+    /// Thrown when an operation, that requires the stack to have at least one element,
+    /// was performed on an empty stack.
+    class EmptyStackException : public std::logic_error {
+    public:
+        EmptyStackException()
+            : std::logic_error("Operation was performed on an empty stack")
+        {}
+    };
+
+public:
+    /// Constructs an empty stack with zero capacity
+    resizing_stack() = default;
+
+    /// Number of elements in the stack
+    size_t size() const noexcept
+    {
+        return m_items.size();
+    }
+
+    /// Size of the underlying buffer
+    size_t capacity() const noexcept
+    {
+        return m_items.capacity();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /// The element on the top of the stack
+    /// @exception EmptyStackException If the stack is empty
+    T& top()
+    {
+        check_not_empty();
+        return m_items[size() - 1];
+    }
+
+    /// The element on the top of the stack
+    /// @exception EmptyStackException If the stack is empty
+    const T& top() const
+    {
+        check_not_empty();
+        return m_items[size() - 1];
+    }
+
+    /// Add value on the top of the stack
+    void push(const T& value)
+    {
+        m_items.push_back(value);
+    }
+
+    /// Remove the element on the top of the stack
+    /// @exception EmptyStackException If the stack is empty
+    void pop()
+    {
+        check_not_empty();
+        m_items.pop_back();
+        shrink_if_sparse();
+    }
+
+    ///
+    /// @brief Pushes count values at once
+    ///
+    /// values[count - 1] ends up on the top. The values must not be
+    /// elements of this stack. If copying a value throws, the stack is
+    /// left as it was.
+    ///
+    void push_n(const T* values, size_t count)
+    {
+        size_t oldSize = size();
+
+        m_items.resize(oldSize + count);
+
+        try {
+            bulk_copy(values, count, m_items.data() + oldSize);
+        }
+        catch (...) {
+            m_items.resize(oldSize);
+            throw;
+        }
+    }
+
+    ///
+    /// @brief Removes up to count elements from the top of the stack
+    ///
+    /// The elements are written to out in the order in which they are
+    /// stored (the top one last), so pop_n reverses a push_n of the same span.
+    ///
+    /// @return The number of removed elements, min(count, size())
+    ///
+    size_t pop_n(T* out, size_t count)
+    {
+        size_t removed = std::min(count, size());
+        size_t newSize = size() - removed;
+
+        bulk_move(m_items.data() + newSize, removed, out);
+        m_items.resize(newSize);
+        shrink_if_sparse();
+
+        return removed;
+    }
+
+    /// Remove all elements and release the buffer
+    void clear()
+    {
+        dynamic_array<T> empty;
+        m_items.swap(empty);
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(resizing_stack& other)
+    {
+        m_items.swap(other.m_items);
+    }
+
+private:
+    void check_not_empty() const
+    {
+        if (empty())
+            throw EmptyStackException();
+    }
+
+    void shrink_if_sparse()
+    {
+        size_t currentCapacity = capacity();
+
+        if (currentCapacity <= min_capacity || size() > currentCapacity / 4)
+            return;
+
+        dynamic_array<T> smaller;
+        smaller.reserve(currentCapacity / 2);
+        smaller.resize(size());
+        bulk_move(m_items.data(), size(), smaller.data());
+
+        m_items.swap(smaller);
+    }
+};
+
+} // namespace
@@ -0,0 +1,309 @@
+#pragma once
+
+#include "bulk_copy.h"
+#include "fixed_size_array.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <stdexcept>
+
+namespace dsa {
+
+///
+/// @brief Double-ended queue stored in a circular buffer
+///
+/// The elements occupy size() consecutive slots of the buffer starting at
+/// m_head, wrapping around at the end. The capacity is always zero or a
+/// power of two, so a position is wrapped with a bit mask instead of a
+/// division. Adding or removing an element at either end is O(1) and does
+/// not allocate (except when the buffer has to grow).
+///
+/// push_back_n and pop_front_n transfer a whole span at once: because of
+/// the wrap-around it is at most two contiguous pieces, each copied with a
+/// single memcpy for trivially copyable types.
+///
+/// The buffer grows by doubling and shrinks by half when it becomes a
+/// quarter full, so that alternating pushes and pops do not reallocate
+/// every time.
+///
+template <typename T>
+class ring_deque {
+
+    fixed_size_array<T> m_buffer;
+    size_t m_head = 0;
+    size_t m_used = 0;
+
+    /// The buffer is never smaller than this (unless it is empty)
+    static constexpr size_t min_capacity = 16;
+
+public:
+
+    /// Thrown when an operation, that requires the deque to have at least one element,
+    /// was performed on an empty deque.
+    class EmptyDequeException : public std::logic_error {
+    public:
+        EmptyDequeException()
+            : std::logic_error("Operation was performed on an empty deque")
+        {}
+    };
+
+public:
+    /// Constructs an empty deque with zero capacity
+    ring_deque() = default;
+
+    // Copy operations
+    ring_deque(const ring_deque&) = default;
+    ring_deque& operator=(const ring_deque&) = default;
+
+    // Move constructor
+    ring_deque(ring_deque&& other)
+        : m_buffer(std::move(other.m_buffer)),
+          m_head(other.m_head),
+          m_used(other.m_used)
+    {
+        other.m_head = 0;
+        other.m_used = 0;
+    }
+
+    // Move assignment
+    ring_deque& operator=(ring_deque&& other)
+    {
+        assert(this != &other); // self-assignment in move assignment is UB
+
+        m_buffer = std::move(other.m_buffer);
+
+        m_head = other.m_head;
+        m_used = other.m_used;
+        other.m_head = 0;
+        other.m_used = 0;
+
+        return *this;
+    }
+
+    /// Number of elements in the deque
+    size_t size() const noexcept
+    {
+        return m_used;
+    }
+
+    /// Size of the underlying buffer
+    size_t capacity() const noexcept
+    {
+        return m_buffer.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_used == 0;
+    }
+
+    /// Retrieve the element at index, counted from the front
+    T& operator[](size_t index)
+    {
+        return m_buffer[slot(index)];
+    }
+
+    /// Retrieve the element at index, counted from the front
+    const T& operator[](size_t index) const
+    {
+        return m_buffer[slot(index)];
+    }
+
+    /// Retrieve the element at index, counted from the front
+    /// @exception std::out_of_range If the index is out of the bounds of the deque
+    T& at(size_t index)
+    {
+        check_index(index);
+        return (*this)[index];
+    }
+
+    /// Retrieve the element at index, counted from the front
+    /// @exception std::out_of_range If the index is out of the bounds of the deque
+    const T& at(size_t index) const
+    {
+        check_index(index);
+        return (*this)[index];
+    }
+
+    /// @exception EmptyDequeException If the deque is empty
+    T& front()
+    {
+        check_not_empty();
+        return m_buffer[m_head];
+    }
+
+    /// @exception EmptyDequeException If the deque is empty
+    const T& front() const
+    {
+        check_not_empty();
+        return m_buffer[m_head];
+    }
+
+    /// @exception EmptyDequeException If the deque is empty
+    T& back()
+    {
+        check_not_empty();
+        return (*this)[m_used - 1];
+    }
+
+    /// @exception EmptyDequeException If the deque is empty
+    const T& back() const
+    {
+        check_not_empty();
+        return (*this)[m_used - 1];
+    }
+
+    void push_back(const T& value)
+    {
+        reserve(m_used + 1);
+        m_buffer[slot(m_used)] = value;
+        ++m_used;
+    }
+
+    void push_front(const T& value)
+    {
+        reserve(m_used + 1);
+        m_head = (m_head - 1) & mask();
+        m_buffer[m_head] = value;
+        ++m_used;
+    }
+
+    /// @exception EmptyDequeException If the deque is empty
+    void pop_back()
+    {
+        check_not_empty();
+        --m_used;
+        shrink_if_sparse();
+    }
+
+    /// @exception EmptyDequeException If the deque is empty
+    void pop_front()
+    {
+        check_not_empty();
+        m_head = (m_head + 1) & mask();
+        --m_used;
+        shrink_if_sparse();
+    }
+
+    ///
+    /// @brief Appends count values at the back
+    ///
+    /// The values must not be elements of this deque.
+    ///
+    void push_back_n(const T* values, size_t count)
+    {
+        reserve(m_used + count);
+
+        size_t tail = slot(m_used);
+        size_t firstPart = std::min(count, capacity() - tail);
+
+        bulk_copy(values, firstPart, m_buffer.data() + tail);
+        bulk_copy(values + firstPart, count - firstPart, m_buffer.data());
+
+        m_used += count;
+    }
+
+    ///
+    /// @brief Removes up to count elements from the front and writes them to out
+    /// @return The number of removed elements, min(count, size())
+    ///
+    size_t pop_front_n(T* out, size_t count)
+    {
+        size_t removed = std::min(count, m_used);
+        size_t firstPart = std::min(removed, capacity() - m_head);
+
+        bulk_move(m_buffer.data() + m_head, firstPart, out);
+        bulk_move(m_buffer.data(), removed - firstPart, out + firstPart);
+
+        if (removed != 0) {
+            m_head = (m_head + removed) & mask();
+            m_used -= removed;
+            shrink_if_sparse();
+        }
+
+        return removed;
+    }
+
+    /// Ensure the buffer can hold at least desiredCapacity elements.
+    /// The capacity is rounded up to a power of two.
+    void reserve(size_t desiredCapacity)
+    {
+        if (desiredCapacity <= capacity())
+            return;
+
+        size_t newCapacity = std::max({ desiredCapacity, capacity() * 2, min_capacity });
+
+        reallocate(std::bit_ceil(newCapacity));
+    }
+
+    /// If possible, reduce the memory used by the deque
+    void shrink_to_fit()
+    {
+        reallocate(m_used == 0 ? 0 : std::bit_ceil(m_used));
+    }
+
+    /// Remove all elements and release the buffer
+    void clear()
+    {
+        ring_deque empty;
+        swap(empty);
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(ring_deque& other)
+    {
+        m_buffer.swap(other.m_buffer);
+        std::swap(m_head, other.m_head);
+        std::swap(m_used, other.m_used);
+    }
+
+private:
+    size_t mask() const noexcept
+    {
+        return capacity() - 1;
+    }
+
+    /// Position in the buffer of the element at index
+    size_t slot(size_t index) const noexcept
+    {
+        return (m_head + index) & mask();
+    }
+
+    void check_index(size_t index) const
+    {
+        if (index >= m_used)
+            throw std::out_of_range("index is out of the bounds of the deque");
+    }
+
+    void check_not_empty() const
+    {
+        if (m_used == 0)
+            throw EmptyDequeException();
+    }
+
+    void shrink_if_sparse()
+    {
+        if (capacity() > min_capacity && m_used <= capacity() / 4)
+            reallocate(capacity() / 2);
+    }
+
+    /// Moves the elements to the beginning of a new buffer of newCapacity elements
+    void reallocate(size_t newCapacity)
+    {
+        if (newCapacity == capacity() && m_head == 0)
+            return;
+
+        fixed_size_array<T> buffer(newCapacity);
+
+        size_t firstPart = std::min(m_used, capacity() - m_head);
+
+        bulk_move(m_buffer.data() + m_head, firstPart, buffer.data());
+        bulk_move(m_buffer.data(), m_used - firstPart, buffer.data() + firstPart);
+
+        m_buffer = std::move(buffer);
+        m_head = 0;
+    }
+};
+
+} // namespace
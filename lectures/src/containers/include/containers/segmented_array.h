@@ -0,0 +1,456 @@
+#pragma once
+
+#include "bulk_copy.h"
+#include "dynamic_array.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <stdexcept>
+
+namespace dsa {
+
+namespace segmented_array_detail {
+
+/// About 4 KiB per block, but never fewer than 16 elements
+template <typename T>
+constexpr size_t default_block_size = std::bit_floor(std::max<size_t>(4096 / sizeof(T), 16));
+
+} // namespace
+
+///
+/// @brief Sequence of elements stored in fixed-size blocks
+///
+/// The array keeps a dynamic_array of pointers to blocks of BlockSize
+/// elements. When the array grows, only a new block is allocated (and
+/// sometimes the array of pointers grows); the elements themselves never
+/// move. This means that:
+///
+/// - pointers and references to elements stay valid until the element is
+///   removed, no matter how many elements are added at either end;
+/// - there are no spikes when the whole array is copied at a doubling
+///   boundary, and no moment when the old and the new buffer have to
+///   exist at the same time;
+/// - push_back and push_front are O(1) (amortized only because of the
+///   array of pointers, which is BlockSize times smaller than the data).
+///
+/// Access by index costs one more indirection than in a dynamic_array.
+/// BlockSize is a power of two, so the index is split into the block and
+/// the position in it with a shift and a mask. Sequential processing
+/// should use for_each_block, which visits whole contiguous blocks.
+///
+/// A block is released when the array shrinks by more than a whole block
+/// past it, so that alternating pushes and pops at a block boundary do
+/// not allocate every time.
+///
+template <typename T, size_t BlockSize = segmented_array_detail::default_block_size<T>>
+class segmented_array {
+
+    static_assert(std::has_single_bit(BlockSize), "BlockSize must be a power of two");
+
+    /// Slots [m_firstBlock, m_blocks.size()) point to allocated blocks.
+    /// The slots before m_firstBlock are free room for push_front.
+    dynamic_array<T*> m_blocks;
+    size_t m_firstBlock = 0;
+
+    /// Position of the first element, counted from the start of slot 0
+    size_t m_begin = 0;
+    size_t m_used = 0;
+
+public:
+
+    /// Thrown when an operation, that requires the array to have at least one element,
+    /// was performed on an empty array.
+    class EmptyArrayException : public std::logic_error {
+    public:
+        EmptyArrayException()
+            : std::logic_error("Operation was performed on an empty array")
+        {}
+    };
+
+public:
+    /// Constructs an empty array without any blocks
+    segmented_array() = default;
+
+    /// Copy constructor
+    segmented_array(const segmented_array& other)
+        : segmented_array() // the destructor releases the blocks if copying throws
+    {
+        other.for_each_block([this](const T* values, size_t count) {
+            push_back_n(values, count);
+        });
+    }
+
+    /// Copy assignment
+    segmented_array& operator=(const segmented_array& other)
+    {
+        if (this != &other) {
+            segmented_array copy(other);
+            swap(copy);
+        }
+
+        return *this;
+    }
+
+    // Move constructor
+    segmented_array(segmented_array&& other)
+        : m_blocks(std::move(other.m_blocks)),
+          m_firstBlock(other.m_firstBlock),
+          m_begin(other.m_begin),
+          m_used(other.m_used)
+    {
+        other.m_firstBlock = 0;
+        other.m_begin = 0;
+        other.m_used = 0;
+    }
+
+    // Move assignment
+    segmented_array& operator=(segmented_array&& other)
+    {
+        assert(this != &other); // self-assignment in move assignment is UB
+
+        segmented_array moved(std::move(other));
+        swap(moved);
+
+        return *this;
+    }
+
+    ~segmented_array()
+    {
+        release_blocks();
+    }
+
+    /// Number of elements in the array
+    size_t size() const noexcept
+    {
+        return m_used;
+    }
+
+    /// Number of elements the allocated blocks can hold
+    size_t capacity() const noexcept
+    {
+        return block_count() * BlockSize;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_used == 0;
+    }
+
+    /// Number of allocated blocks
+    size_t block_count() const noexcept
+    {
+        return m_blocks.size() - m_firstBlock;
+    }
+
+    /// Number of elements in one block
+    static constexpr size_t block_size() noexcept
+    {
+        return BlockSize;
+    }
+
+    /// Retrieve the element at index
+    T& operator[](size_t index)
+    {
+        return element(m_begin + index);
+    }
+
+    /// Retrieve the element at index
+    const T& operator[](size_t index) const
+    {
+        return element(m_begin + index);
+    }
+
+    /// Retrieve the element at index
+    /// @exception std::out_of_range If the index is out of the bounds of the array
+    T& at(size_t index)
+    {
+        check_index(index);
+        return (*this)[index];
+    }
+
+    /// Retrieve the element at index
+    /// @exception std::out_of_range If the index is out of the bounds of the array
+    const T& at(size_t index) const
+    {
+        check_index(index);
+        return (*this)[index];
+    }
+
+    /// @exception EmptyArrayException If the array is empty
+    T& front()
+    {
+        check_not_empty();
+        return element(m_begin);
+    }
+
+    /// @exception EmptyArrayException If the array is empty
+    const T& front() const
+    {
+        check_not_empty();
+        return element(m_begin);
+    }
+
+    /// @exception EmptyArrayException If the array is empty
+    T& back()
+    {
+        check_not_empty();
+        return element(end_position() - 1);
+    }
+
+    /// @exception EmptyArrayException If the array is empty
+    const T& back() const
+    {
+        check_not_empty();
+        return element(end_position() - 1);
+    }
+
+    /// Append value to the array. No existing element moves.
+    void push_back(const T& value)
+    {
+        if (end_position() == m_blocks.size() * BlockSize)
+            add_block_back();
+
+        element(end_position()) = value;
+        ++m_used;
+    }
+
+    /// Prepend value to the array. No existing element moves.
+    void push_front(const T& value)
+    {
+        if (m_begin == m_firstBlock * BlockSize)
+            add_block_front();
+
+        element(m_begin - 1) = value;
+        --m_begin;
+        ++m_used;
+    }
+
+    /// @exception EmptyArrayException If the array is empty
+    void pop_back()
+    {
+        check_not_empty();
+        --m_used;
+
+        if (m_blocks.size() * BlockSize - end_position() >= 2 * BlockSize)
+            release_last_block();
+    }
+
+    /// @exception EmptyArrayException If the array is empty
+    void pop_front()
+    {
+        check_not_empty();
+        ++m_begin;
+        --m_used;
+
+        if (m_begin - m_firstBlock * BlockSize >= 2 * BlockSize)
+            release_first_block();
+    }
+
+    ///
+    /// @brief Appends count values at the back
+    ///
+    /// The values are copied block by block, with a single memcpy per block
+    /// for trivially copyable types. Since no element moves, the values
+    /// may also be elements of this array.
+    ///
+    void push_back_n(const T* values, size_t count)
+    {
+        while (count != 0) {
+            if (end_position() == m_blocks.size() * BlockSize)
+                add_block_back();
+
+            size_t offset = end_position() % BlockSize;
+            size_t part = std::min(count, BlockSize - offset);
+
+            bulk_copy(values, part, m_blocks[end_position() / BlockSize] + offset);
+
+            m_used += part;
+            values += part;
+            count -= part;
+        }
+    }
+
+    ///
+    /// @brief Calls function(values, count) for every contiguous run of elements
+    ///
+    /// The runs cover the array in order. Each of them lies in one block,
+    /// so only the first and the last one can be shorter than BlockSize.
+    ///
+    template <typename Function>
+    void for_each_block(Function function)
+    {
+        for (size_t position = m_begin; position < end_position(); ) {
+            size_t offset = position % BlockSize;
+            size_t count = std::min(BlockSize - offset, end_position() - position);
+
+            function(m_blocks[position / BlockSize] + offset, count);
+            position += count;
+        }
+    }
+
+    /// Calls function(values, count) for every contiguous run of elements
+    template <typename Function>
+    void for_each_block(Function function) const
+    {
+        for (size_t position = m_begin; position < end_position(); ) {
+            size_t offset = position % BlockSize;
+            size_t count = std::min(BlockSize - offset, end_position() - position);
+
+            function(static_cast<const T*>(m_blocks[position / BlockSize] + offset), count);
+            position += count;
+        }
+    }
+
+    /// Calls function(element) for every element, from the front to the back
+    template <typename Function>
+    void for_each(Function function)
+    {
+        for_each_block([&function](T* values, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                function(values[i]);
+        });
+    }
+
+    /// Calls function(element) for every element, from the front to the back
+    template <typename Function>
+    void for_each(Function function) const
+    {
+        for_each_block([&function](const T* values, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                function(values[i]);
+        });
+    }
+
+    ///
+    /// @brief Releases the blocks which hold no elements
+    ///
+    /// Unlike dynamic_array::shrink_to_fit, the elements stay where they are,
+    /// so pointers to them remain valid.
+    ///
+    void shrink_to_fit()
+    {
+        if (m_used == 0) {
+            clear();
+            return;
+        }
+
+        while (m_blocks.size() * BlockSize - end_position() >= BlockSize)
+            release_last_block();
+
+        while (m_begin - m_firstBlock * BlockSize >= BlockSize)
+            release_first_block();
+
+        compact_blocks();
+        m_blocks.shrink_to_fit();
+    }
+
+    /// Remove all elements and release all blocks
+    void clear()
+    {
+        segmented_array empty;
+        swap(empty);
+    }
+
+    /// Quickly swaps the contents of this object with that of another
+    void swap(segmented_array& other)
+    {
+        m_blocks.swap(other.m_blocks);
+        std::swap(m_firstBlock, other.m_firstBlock);
+        std::swap(m_begin, other.m_begin);
+        std::swap(m_used, other.m_used);
+    }
+
+private:
+    size_t end_position() const noexcept
+    {
+        return m_begin + m_used;
+    }
+
+    T& element(size_t position)
+    {
+        return m_blocks[position / BlockSize][position % BlockSize];
+    }
+
+    const T& element(size_t position) const
+    {
+        return m_blocks[position / BlockSize][position % BlockSize];
+    }
+
+    void check_index(size_t index) const
+    {
+        if (index >= m_used)
+            throw std::out_of_range("index is out of the bounds of the array");
+    }
+
+    void check_not_empty() const
+    {
+        if (m_used == 0)
+            throw EmptyArrayException();
+    }
+
+    /// Moves the pointers to the allocated blocks to the start of m_blocks
+    void compact_blocks()
+    {
+        if (m_firstBlock == 0)
+            return;
+
+        std::copy(m_blocks.data() + m_firstBlock, m_blocks.data() + m_blocks.size(), m_blocks.data());
+
+        m_blocks.resize(block_count());
+        m_begin -= m_firstBlock * BlockSize;
+        m_firstBlock = 0;
+    }
+
+    void add_block_back()
+    {
+        // When the free room at the front is as large as the used part,
+        // reuse it instead of growing (e.g. when the array is used as a queue)
+        if (m_firstBlock != 0 && m_firstBlock >= block_count())
+            compact_blocks();
+
+        // Make room for the pointer first, so that the block cannot leak
+        m_blocks.reserve(m_blocks.size() + 1);
+        m_blocks.push_back(new T[BlockSize]);
+    }
+
+    void add_block_front()
+    {
+        if (m_firstBlock == 0) {
+            // Free room at the front as large as the used part keeps push_front amortized O(1)
+            size_t room = std::max<size_t>(block_count(), 1);
+
+            dynamic_array<T*> blocks(room + block_count());
+            std::fill(blocks.data(), blocks.data() + room, nullptr);
+            std::copy(m_blocks.data(), m_blocks.data() + m_blocks.size(), blocks.data() + room);
+
+            m_blocks = std::move(blocks);
+            m_firstBlock = room;
+            m_begin += room * BlockSize;
+        }
+
+        m_blocks[m_firstBlock - 1] = new T[BlockSize];
+        --m_firstBlock;
+    }
+
+    void release_last_block()
+    {
+        delete [] m_blocks[m_blocks.size() - 1];
+        m_blocks.pop_back();
+    }
+
+    void release_first_block()
+    {
+        delete [] m_blocks[m_firstBlock];
+        m_blocks[m_firstBlock] = nullptr;
+        ++m_firstBlock;
+    }
+
+    void release_blocks() noexcept
+    {
+        for (size_t i = m_firstBlock; i < m_blocks.size(); ++i)
+            delete [] m_blocks[i];
+    }
+};
+
+} // namespace
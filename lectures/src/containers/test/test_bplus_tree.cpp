@@ -0,0 +1,311 @@
+#include "catch2/catch_all.hpp"
+
+#include <cassert>
+
+#include "containers/bplus_tree.h"
+#include "test_helpers.h"
+#include "utils/random.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+using dsa::bplus_tree;
+using dsa::dynamic_array;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+namespace {
+
+// Small nodes, so that even small tests build trees with several levels
+template <typename Key, typename Value>
+using small_tree = bplus_tree<Key, Value, std::less<Key>, DebugAllocator, 64>;
+
+}
+
+
+//----------------------------------------------------------------------
+// Lookup and modification
+//
+
+TEST_CASE("bplus_tree() constructs an empty tree", "[bplus_tree]")
+{
+  bplus_tree<int, int> tree;
+
+  CHECK(tree.empty());
+  CHECK(tree.height() == 0);
+  CHECK(tree.find(1) == nullptr);
+  CHECK_FALSE(tree.erase(1));
+  CHECK_THROWS_AS(tree.at(1), std::out_of_range);
+
+  size_t visited = 0;
+  tree.for_each([&](int, int) { ++visited; });
+  tree.for_each_in_range(0, 10, [&](int, int) { ++visited; });
+  CHECK(visited == 0);
+}
+
+TEST_CASE("bplus_tree nodes occupy whole cache lines", "[bplus_tree]")
+{
+  using tree = bplus_tree<uint64_t, uint64_t>;
+
+  CHECK(sizeof(tree::leaf_node) == 256);
+  CHECK(sizeof(tree::inner_node) == 256);
+  CHECK(alignof(tree::leaf_node) == 64);
+  CHECK(tree::leaf_node_capacity() == 15);
+}
+
+TEMPLATE_TEST_CASE("count_less() counts the smaller keys", "[bplus_tree]", int32_t, int64_t, uint16_t, double)
+{
+  // Values around the boundaries of the 32-bit halves of 64-bit keys
+  const int64_t boundaries[] = {
+    INT64_MIN, INT64_MIN + 1, -(int64_t(1) << 32) - 1, -(int64_t(1) << 32), int64_t(INT32_MIN) - 1, INT32_MIN,
+    -2, -1, 0, 1, 2, INT32_MAX, int64_t(INT32_MAX) + 1, UINT32_MAX, int64_t(UINT32_MAX) + 1, INT64_MAX - 1, INT64_MAX
+  };
+
+  std::vector<TestType> values;
+  for (int64_t value : boundaries)
+    values.push_back(static_cast<TestType>(value));
+
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+
+  for (size_t count = 0; count <= values.size(); ++count) {
+    for (TestType key : values) {
+      size_t expected = std::lower_bound(values.begin(), values.begin() + count, key) - values.begin();
+      REQUIRE(dsa::bplus_tree_detail::count_less(values.data(), count, key, std::less<TestType>()) == expected);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("bplus_tree behaves like std::map", "[bplus_tree]", int32_t, int64_t, uint16_t, double)
+{
+  // Small key range, so that the random operations hit existing keys often
+  const uint64_t keyRange = GENERATE(100, 5000);
+
+  small_tree<TestType, int> tree;
+  std::map<TestType, int> expected;
+
+  uint64_t state = 1;
+  for (int step = 0; step < 20'000; ++step) {
+    TestType key = static_cast<TestType>(nextRandom(state) % keyRange);
+
+    switch (nextRandom(state) % 3) {
+    case 0:
+      REQUIRE(tree.insert_or_assign(key, step) == expected.insert_or_assign(key, step).second);
+      break;
+    case 1:
+      REQUIRE(tree.erase(key) == (expected.erase(key) == 1));
+      break;
+    default:
+      const int* value = tree.find(key);
+      auto it = expected.find(key);
+      REQUIRE((value != nullptr) == (it != expected.end()));
+      if (value)
+        REQUIRE(*value == it->second);
+    }
+
+    REQUIRE(tree.size() == expected.size());
+  }
+
+  requireSameEntries(tree, expected);
+
+  tree.clear();
+  CHECK(tree.empty());
+  CHECK(tree.leaf_allocator().activeAllocationsCount() == 0);
+  CHECK(tree.inner_allocator().activeAllocationsCount() == 0);
+}
+
+TEST_CASE("bplus_tree works with keys compared without SIMD", "[bplus_tree]")
+{
+  small_tree<std::string, size_t> tree;
+  std::map<std::string, size_t> expected;
+
+  for (size_t i = 0; i < 500; ++i) {
+    std::string key = std::to_string((i * 7919) % 1000);
+    CHECK(tree.insert(key, i).second == expected.emplace(key, i).second);
+  }
+
+  for (size_t i = 0; i < 500; i += 2)
+    CHECK(tree.erase(std::to_string((i * 7919) % 1000)) == (expected.erase(std::to_string((i * 7919) % 1000)) == 1));
+
+  requireSameEntries(tree, expected);
+}
+
+TEST_CASE("bplus_tree::insert() does not replace existing values", "[bplus_tree]")
+{
+  bplus_tree<int, std::string> tree;
+
+  auto [value, inserted] = tree.insert(5, "five");
+  CHECK(inserted);
+  CHECK(*value == "five");
+
+  auto [existing, insertedAgain] = tree.insert(5, "FIVE");
+  CHECK_FALSE(insertedAgain);
+  CHECK(*existing == "five");
+  CHECK(tree.at(5) == "five");
+}
+
+TEST_CASE("bplus_tree grows and shrinks in height", "[bplus_tree]")
+{
+  small_tree<int, int> tree;
+
+  for (int i = 0; i < 10'000; ++i)
+    tree.insert(i, i);
+
+  // At least half full nodes with at most 6 entries (leaves) and 5 children (inner nodes)
+  CHECK(tree.height() >= 6);
+  CHECK(tree.height() <= 10);
+
+  for (int i = 0; i < 10'000; ++i)
+    REQUIRE(tree.erase(i));
+
+  CHECK(tree.empty());
+  CHECK(tree.height() == 0);
+  CHECK(tree.leaf_allocator().activeAllocationsCount() == 0);
+  CHECK(tree.inner_allocator().activeAllocationsCount() == 0);
+}
+
+
+//----------------------------------------------------------------------
+// Range scans
+//
+
+TEST_CASE("bplus_tree::for_each_in_range() visits the keys in a half-open range", "[bplus_tree]")
+{
+  small_tree<int, int> tree;
+  for (int i = 0; i < 1000; ++i)
+    tree.insert(i * 2, i);
+
+  SECTION("a range in the middle") {
+    std::vector<int> visited;
+    tree.for_each_in_range(101, 201, [&](int key, int) { visited.push_back(key); });
+
+    REQUIRE(visited.size() == 50);
+    for (size_t i = 0; i < visited.size(); ++i)
+      REQUIRE(visited[i] == static_cast<int>(102 + 2 * i));
+  }
+  SECTION("ranges outside of the keys") {
+    size_t visited = 0;
+    tree.for_each_in_range(-10, 0, [&](int, int) { ++visited; });
+    tree.for_each_in_range(2000, 3000, [&](int, int) { ++visited; });
+    CHECK(visited == 0);
+  }
+}
+
+
+//----------------------------------------------------------------------
+// Bulk loading
+//
+
+TEST_CASE("bplus_tree::bulk_load() builds the tree from sorted arrays", "[bplus_tree]")
+{
+  const size_t count = GENERATE(size_t(0), size_t(1), size_t(6), size_t(7), size_t(31), size_t(10'000));
+
+  dynamic_array<int> keys(count);
+  dynamic_array<int> values(count);
+  std::map<int, int> expected;
+
+  for (size_t i = 0; i < count; ++i) {
+    keys[i] = static_cast<int>(3 * i);
+    values[i] = static_cast<int>(i);
+    expected.emplace(keys[i], values[i]);
+  }
+
+  small_tree<int, int> tree;
+  tree.insert(-1, -1); // replaced by the bulk load
+  tree.bulk_load(keys, values);
+
+  requireSameEntries(tree, expected);
+
+  // The tree stays valid for further changes
+  uint64_t state = 5;
+  for (int step = 0; step < 5000; ++step) {
+    int key = static_cast<int>(nextRandom(state) % (3 * count + 10));
+    if (step % 2 == 0) {
+      REQUIRE(tree.erase(key) == (expected.erase(key) == 1));
+    }
+    else {
+      REQUIRE(tree.insert(key, step).second == expected.emplace(key, step).second);
+    }
+  }
+
+  requireSameEntries(tree, expected);
+}
+
+TEST_CASE("bplus_tree::bulk_load() rejects invalid input", "[bplus_tree]")
+{
+  bplus_tree<int, int> tree;
+  dynamic_array<int> keys(3);
+  dynamic_array<int> values(3);
+
+  keys[0] = 1;
+  keys[1] = 2;
+  keys[2] = 2;
+
+  CHECK_THROWS_AS(tree.bulk_load(keys, values), std::invalid_argument);
+  CHECK_THROWS_AS(tree.bulk_load(keys, dynamic_array<int>(2)), std::invalid_argument);
+}
+
+
+//----------------------------------------------------------------------
+// Allocation failures
+//
+
+TEST_CASE("bplus_tree::insert() leaves the tree unchanged when an allocation fails", "[bplus_tree]")
+{
+  small_tree<int, int> tree;
+  std::map<int, int> expected;
+
+  uint64_t state = 3;
+  size_t failures = 0;
+
+  for (int step = 0; step < 2000; ++step) {
+    // Allow only a few more allocations of each kind
+    tree.leaf_allocator().failAfter(tree.leaf_allocator().totalAllocationsCount() + nextRandom(state) % 3);
+    tree.inner_allocator().failAfter(tree.inner_allocator().totalAllocationsCount() + nextRandom(state) % 3);
+
+    int key = static_cast<int>(nextRandom(state) % 100'000);
+
+    try {
+      tree.insert(key, step);
+      expected.emplace(key, step);
+    }
+    catch (std::bad_alloc&) {
+      ++failures;
+    }
+  }
+
+  CHECK(failures > 0);
+  requireSameEntries(tree, expected);
+
+  tree.clear();
+  CHECK(tree.leaf_allocator().activeAllocationsCount() == 0);
+  CHECK(tree.inner_allocator().activeAllocationsCount() == 0);
+}
+
+TEST_CASE("bplus_tree::bulk_load() releases everything when an allocation fails", "[bplus_tree]")
+{
+  const size_t count = 1000;
+  dynamic_array<int> keys(count);
+  dynamic_array<int> values(count);
+  for (size_t i = 0; i < count; ++i)
+    keys[i] = values[i] = static_cast<int>(i);
+
+  small_tree<int, int> tree;
+
+  SECTION("while building the leaves") {
+    tree.leaf_allocator().failAfter(100);
+  }
+  SECTION("while building the inner nodes") {
+    tree.inner_allocator().failAfter(30);
+  }
+
+  CHECK_THROWS_AS(tree.bulk_load(keys, values), std::bad_alloc);
+  CHECK(tree.empty());
+  CHECK(tree.leaf_allocator().activeAllocationsCount() == 0);
+  CHECK(tree.inner_allocator().activeAllocationsCount() == 0);
+}
@@ -0,0 +1,279 @@
+#include "catch2/catch_all.hpp"
+
+#include "containers/dynamic_array.h"
+
+using dsa::dynamic_array;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+/// Produces an irregular pattern of bits, so that neighbouring elements differ
+bool patternBit(size_t index)
+{
+  return (index * 7 + index / 3) % 5 < 2;
+}
+
+/// Appends `count` elements that follow patternBit()
+void fillWithPattern(dynamic_array<bool>& arr, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+    arr.push_back(patternBit(i));
+}
+
+/// Checks whether the elements of arr follow patternBit()
+bool followsPattern(const dynamic_array<bool>& arr)
+{
+  for (size_t i = 0; i < arr.size(); ++i) {
+    if (arr[i] != patternBit(i))
+      return false;
+  }
+
+  return true;
+}
+
+
+//----------------------------------------------------------------------
+// Constructors
+//
+
+TEST_CASE("dynamic_array<bool>::dynamic_array() constructs an empty array", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr;
+  CHECK(arr.size() == 0);
+  CHECK(arr.capacity() == 0);
+}
+
+TEST_CASE("dynamic_array<bool>::dynamic_array(N) constructs an array of N false elements", "[dynamic_array][bool]")
+{
+  const size_t size = 130;
+  dynamic_array<bool> arr(size);
+
+  REQUIRE(arr.size() == size);
+  REQUIRE(arr.capacity() >= size);
+
+  for (size_t i = 0; i < size; ++i)
+    REQUIRE_FALSE(arr[i]);
+}
+
+TEST_CASE("dynamic_array<bool> stores one bit per element", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr(1000);
+  REQUIRE(arr.capacity() == 1024); // 16 words of 64 bits
+}
+
+
+//----------------------------------------------------------------------
+// Access to the elements
+//
+
+TEST_CASE("dynamic_array<bool>::operator[] can be used to read and write elements", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr(200);
+  const dynamic_array<bool>& cref = arr;
+
+  for (size_t i = 0; i < arr.size(); ++i)
+    arr[i] = patternBit(i);
+
+  SECTION("operator[] can retrieve the elements") {
+    for (size_t i = 0; i < arr.size(); ++i)
+      REQUIRE(arr[i] == patternBit(i));
+  }
+  SECTION("operator[] const can retrieve the elements") {
+    REQUIRE(followsPattern(cref));
+  }
+}
+
+TEST_CASE("dynamic_array<bool>::reference changes only its own bit", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr(3);
+
+  arr[1] = true;
+  CHECK_FALSE(arr[0]);
+  CHECK(arr[1]);
+  CHECK_FALSE(arr[2]);
+
+  arr[0] = arr[1];
+  CHECK(arr[0]);
+
+  arr[1].flip();
+  CHECK(arr[0]);
+  CHECK_FALSE(arr[1]);
+}
+
+TEST_CASE("dynamic_array<bool>::at() throws if the index is not valid", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr(10);
+  const dynamic_array<bool>& cref = arr;
+
+  REQUIRE_THROWS_AS(arr.at(arr.size()), std::out_of_range);
+  REQUIRE_THROWS_AS(cref.at(cref.size()), std::out_of_range);
+}
+
+
+//----------------------------------------------------------------------
+// Adding and removing elements
+//
+
+TEST_CASE("dynamic_array<bool>::push_back() appends elements to the back of the array", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr;
+  fillWithPattern(arr, 1000);
+
+  REQUIRE(arr.size() == 1000);
+  REQUIRE(followsPattern(arr));
+}
+
+TEST_CASE("dynamic_array<bool>::pop_back() removes the last element", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr;
+  fillWithPattern(arr, 65);
+
+  arr.pop_back();
+
+  REQUIRE(arr.size() == 64);
+  REQUIRE(followsPattern(arr));
+}
+
+TEST_CASE("dynamic_array<bool>::pop_back() throws when the array is empty", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr;
+  REQUIRE_THROWS_AS(arr.pop_back(), dynamic_array<bool>::EmptyArrayException);
+}
+
+
+//----------------------------------------------------------------------
+// Resizing
+//
+
+TEST_CASE("dynamic_array<bool>::reserve() does not alter the elements", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr;
+  fillWithPattern(arr, 100);
+
+  arr.reserve(5000);
+
+  REQUIRE(arr.capacity() >= 5000);
+  REQUIRE(arr.size() == 100);
+  REQUIRE(followsPattern(arr));
+}
+
+TEST_CASE("dynamic_array<bool>::resize() sets the new elements to the given value", "[dynamic_array][bool]")
+{
+  const bool value = GENERATE(false, true);
+
+  dynamic_array<bool> arr;
+  fillWithPattern(arr, 37);
+
+  arr.resize(300, value);
+
+  REQUIRE(arr.size() == 300);
+
+  for (size_t i = 0; i < 37; ++i)
+    REQUIRE(arr[i] == patternBit(i));
+
+  for (size_t i = 37; i < 300; ++i)
+    REQUIRE(arr[i] == value);
+}
+
+TEST_CASE("dynamic_array<bool>::resize() does not expose old values after shrinking and growing", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr(100);
+  arr.resize(100, false);
+  for (size_t i = 0; i < arr.size(); ++i)
+    arr[i] = true;
+
+  arr.resize(10);
+  arr.resize(100, false);
+
+  for (size_t i = 10; i < 100; ++i)
+    REQUIRE_FALSE(arr[i]);
+}
+
+TEST_CASE("dynamic_array<bool>::shrink_to_fit() keeps the elements", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr;
+  fillWithPattern(arr, 70);
+  arr.reserve(10000);
+
+  arr.shrink_to_fit();
+
+  REQUIRE(arr.capacity() == 128);
+  REQUIRE(followsPattern(arr));
+}
+
+
+//----------------------------------------------------------------------
+// Copying, moving and comparison
+//
+
+TEST_CASE("dynamic_array<bool> can be copied and moved", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr;
+  fillWithPattern(arr, 150);
+
+  SECTION("Copy construction") {
+    dynamic_array<bool> copy = arr;
+    REQUIRE(copy == arr);
+  }
+  SECTION("Copy assignment") {
+    dynamic_array<bool> copy(3);
+    copy = arr;
+    REQUIRE(copy == arr);
+  }
+  SECTION("Move construction") {
+    dynamic_array<bool> movedTo(std::move(arr));
+    REQUIRE(movedTo.size() == 150);
+    REQUIRE(followsPattern(movedTo));
+    REQUIRE(arr.size() == 0);
+  }
+  SECTION("Move assignment") {
+    dynamic_array<bool> movedTo(3);
+    movedTo = std::move(arr);
+    REQUIRE(movedTo.size() == 150);
+    REQUIRE(followsPattern(movedTo));
+    REQUIRE(arr.size() == 0);
+  }
+}
+
+TEST_CASE("dynamic_array<bool>::operator== compares sizes and elements", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> left, right;
+  fillWithPattern(left, 100);
+  fillWithPattern(right, 100);
+
+  SECTION("Arrays with the same elements are equal") {
+    REQUIRE(left == right);
+  }
+  SECTION("Arrays with different sizes are not equal") {
+    right.pop_back();
+    REQUIRE_FALSE(left == right);
+  }
+  SECTION("A difference in a full word is detected") {
+    right[3].flip();
+    REQUIRE_FALSE(left == right);
+  }
+  SECTION("A difference in the last, partial word is detected") {
+    right[99].flip();
+    REQUIRE_FALSE(left == right);
+  }
+  SECTION("Bits past the end are ignored") {
+    left.push_back(true);
+    right.push_back(false);
+    left.pop_back();
+    right.pop_back();
+    REQUIRE(left == right);
+  }
+}
+
+TEST_CASE("dynamic_array<bool>::swap() exchanges the contents of two arrays", "[dynamic_array][bool]")
+{
+  dynamic_array<bool> arr, other(5);
+  fillWithPattern(arr, 80);
+
+  arr.swap(other);
+
+  REQUIRE(arr.size() == 5);
+  REQUIRE(other.size() == 80);
+  REQUIRE(followsPattern(other));
+}
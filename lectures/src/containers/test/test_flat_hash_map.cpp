@@ -0,0 +1,271 @@
+#include "catch2/catch_all.hpp"
+
+#include <cassert>
+
+#include "containers/flat_hash_map.h"
+#include "test_helpers.h"
+#include "utils/random.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using dsa::flat_hash_map;
+using dsa::flat_hash_set;
+
+//----------------------------------------------------------------------
+// Helper types
+//
+
+namespace {
+
+// Hashes std::string and std::string_view the same way, for heterogeneous lookup
+struct string_hash {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view text) const
+  {
+    return std::hash<std::string_view>()(text);
+  }
+};
+
+// Puts every key into the same home slot, so that all keys share one long run
+struct colliding_hash {
+  size_t operator()(int) const
+  {
+    return 0;
+  }
+};
+
+}
+
+
+//----------------------------------------------------------------------
+// flat_hash_map
+//
+
+TEST_CASE("flat_hash_map() constructs an empty map", "[flat_hash_map]")
+{
+  flat_hash_map<int, int> map;
+
+  CHECK(map.empty());
+  CHECK(map.size() == 0);
+  CHECK(map.capacity() == 0);
+  CHECK(map.find(1) == nullptr);
+  CHECK_FALSE(map.contains(1));
+  CHECK_FALSE(map.erase(1));
+}
+
+TEST_CASE("flat_hash_map::insert() adds new keys only", "[flat_hash_map]")
+{
+  flat_hash_map<std::string, int> map;
+
+  auto [value, inserted] = map.insert("one", 1);
+  CHECK(inserted);
+  CHECK(*value == 1);
+
+  auto [existing, insertedAgain] = map.insert("one", 100);
+  CHECK_FALSE(insertedAgain);
+  CHECK(*existing == 1);
+
+  CHECK_FALSE(map.insert_or_assign("one", 100));
+  CHECK(map.at("one") == 100);
+  CHECK(map.size() == 1);
+
+  map["two"] += 2;
+  CHECK(map.at("two") == 2);
+  CHECK(map.size() == 2);
+
+  CHECK_THROWS_AS(map.at("three"), std::out_of_range);
+}
+
+TEST_CASE("flat_hash_map::insert() leaves the map unchanged when copying the entry throws", "[flat_hash_map]")
+{
+  // Reserved, so that the failing insert does not rehash (which copies as well)
+  SECTION("the value throws") {
+    flat_hash_map<int, throwing_int> map;
+    map.reserve(100);
+    for (int i = 0; i < 5; ++i)
+      map.insert(i, i);
+
+    throwing_int::failAssignment = true;
+    CHECK_THROWS_AS(map.insert(100, 100), std::runtime_error);
+    CHECK_THROWS_AS(map.insert_or_assign(100, 100), std::runtime_error);
+    throwing_int::failAssignment = false;
+
+    CHECK(map.size() == 5);
+    CHECK_FALSE(map.contains(100));
+    CHECK(map.insert(100, 7).second);
+    CHECK(map.at(100).value == 7);
+  }
+  SECTION("the key throws") {
+    flat_hash_map<throwing_int, int, throwing_int_hash> map;
+    map.reserve(100);
+    for (int i = 0; i < 5; ++i)
+      map.insert(i, i);
+
+    throwing_int::failAssignment = true;
+    CHECK_THROWS_AS(map.insert(100, 100), std::runtime_error);
+    CHECK_THROWS_AS(map[100], std::runtime_error);
+    throwing_int::failAssignment = false;
+
+    CHECK(map.size() == 5);
+    CHECK_FALSE(map.contains(100));
+
+    // The slot which the failed insert used is free for other keys
+    for (int i = 0; i < 5; ++i)
+      CHECK(map.erase(i));
+    CHECK(map.empty());
+    CHECK(map.insert(100, 7).second);
+    CHECK(map.at(100) == 7);
+  }
+}
+
+TEST_CASE("flat_hash_map behaves like std::unordered_map", "[flat_hash_map]")
+{
+  // Small key range, so that the random operations hit existing keys often
+  const int keyRange = GENERATE(50, 5000);
+
+  flat_hash_map<int, int> map;
+  std::unordered_map<int, int> expected;
+
+  uint64_t state = 1;
+  for (int step = 0; step < 50'000; ++step) {
+    int key = static_cast<int>(nextRandom(state) % keyRange);
+
+    switch (nextRandom(state) % 3) {
+    case 0:
+      map.insert_or_assign(key, step);
+      expected[key] = step;
+      break;
+    case 1:
+      REQUIRE(map.erase(key) == (expected.erase(key) == 1));
+      break;
+    default:
+      const int* value = map.find(key);
+      auto it = expected.find(key);
+      REQUIRE((value != nullptr) == (it != expected.end()));
+      if (value)
+        REQUIRE(*value == it->second);
+    }
+
+    REQUIRE(map.size() == expected.size());
+  }
+
+  requireSameEntries(map, expected);
+}
+
+TEST_CASE("flat_hash_map::erase() keeps colliding keys reachable", "[flat_hash_map]")
+{
+  flat_hash_map<int, int, colliding_hash> map;
+
+  for (int i = 0; i < 40; ++i)
+    map.insert(i, i * 10);
+
+  // Erasing from the front and the middle of the run shifts the rest back
+  for (int i = 0; i < 40; i += 3)
+    REQUIRE(map.erase(i));
+
+  for (int i = 0; i < 40; ++i) {
+    if (i % 3 == 0) {
+      REQUIRE_FALSE(map.contains(i));
+    }
+    else {
+      REQUIRE(map.find(i) != nullptr);
+      REQUIRE(*map.find(i) == i * 10);
+    }
+  }
+}
+
+TEST_CASE("flat_hash_map::reserve() makes room without rehashing", "[flat_hash_map]")
+{
+  flat_hash_map<int, int> map;
+  map.reserve(1000);
+
+  const size_t capacity = map.capacity();
+  REQUIRE(capacity >= 1000);
+
+  for (int i = 0; i < 1000; ++i)
+    map.insert(i, i);
+
+  CHECK(map.capacity() == capacity);
+
+  map.clear();
+  CHECK(map.empty());
+  CHECK(map.capacity() == capacity);
+  CHECK_FALSE(map.contains(5));
+}
+
+TEST_CASE("flat_hash_map supports heterogeneous lookup", "[flat_hash_map]")
+{
+  flat_hash_map<std::string, int, string_hash, std::equal_to<>> map;
+  map.insert("apple", 1);
+  map.insert("pear", 2);
+
+  std::string_view key = "apple";
+  CHECK(map.contains(key));
+  CHECK(*map.find(key) == 1);
+  CHECK(map.erase(std::string_view("pear")));
+  CHECK(map.size() == 1);
+}
+
+TEST_CASE("flat_hash_map can be copied, moved and swapped", "[flat_hash_map]")
+{
+  flat_hash_map<int, std::string> map;
+  for (int i = 0; i < 100; ++i)
+    map.insert(i, std::to_string(i));
+
+  flat_hash_map<int, std::string> copy = map;
+  map.erase(5);
+  CHECK(copy.at(5) == "5");
+
+  flat_hash_map<int, std::string> moved = std::move(copy);
+  CHECK(moved.size() == 100);
+  CHECK(copy.size() == 0);
+
+  flat_hash_map<int, std::string> other;
+  other.swap(moved);
+  CHECK(other.size() == 100);
+  CHECK(moved.empty());
+}
+
+
+//----------------------------------------------------------------------
+// flat_hash_set
+//
+
+TEST_CASE("flat_hash_set stores each key once", "[flat_hash_set]")
+{
+  flat_hash_set<int> set;
+
+  for (int i = 0; i < 1000; ++i)
+    REQUIRE(set.insert(i % 500) == (i < 500));
+
+  CHECK(set.size() == 500);
+  CHECK(set.contains(499));
+  CHECK_FALSE(set.contains(500));
+
+  for (int i = 0; i < 500; i += 2)
+    CHECK(set.erase(i));
+
+  long long sum = 0;
+  set.for_each([&](int key) { sum += key; });
+  CHECK(sum == 250 * 250);
+}
+
+TEST_CASE("flat_hash_set::insert() leaves the set unchanged when copying the key throws", "[flat_hash_set]")
+{
+  flat_hash_set<throwing_int, throwing_int_hash> set;
+  set.reserve(100);
+  set.insert(1);
+
+  throwing_int::failAssignment = true;
+  CHECK_THROWS_AS(set.insert(2), std::runtime_error);
+  throwing_int::failAssignment = false;
+
+  CHECK(set.size() == 1);
+  CHECK_FALSE(set.contains(2));
+  CHECK(set.insert(2));
+}
@@ -0,0 +1,246 @@
+#include "catch2/catch_all.hpp"
+
+#include <cassert>
+
+#include "containers/flat_map.h"
+#include "test_helpers.h"
+#include "utils/random.h"
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using dsa::flat_map;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+namespace {
+
+// A throwing_int which can be moved without throwing, so that insert_n()
+// merges it in place instead of into new arrays
+struct movable_throwing_int : throwing_int {
+  using throwing_int::throwing_int;
+
+  movable_throwing_int() = default;
+  movable_throwing_int(const movable_throwing_int&) = default;
+  movable_throwing_int& operator=(const movable_throwing_int&) = default;
+
+  movable_throwing_int& operator=(movable_throwing_int&& other) noexcept
+  {
+    value = other.value;
+    return *this;
+  }
+};
+
+std::vector<int> randomKeys(size_t count, int range, uint64_t seed)
+{
+  std::vector<int> keys(count);
+  for (int& key : keys)
+    key = static_cast<int>(nextRandom(seed) % range);
+  return keys;
+}
+
+}
+
+
+//----------------------------------------------------------------------
+// Lookup
+//
+
+TEST_CASE("flat_map() constructs an empty map", "[flat_map]")
+{
+  flat_map<int, int> map;
+
+  CHECK(map.empty());
+  CHECK(map.lower_bound(5) == 0);
+  CHECK(map.find(5) == nullptr);
+  CHECK_FALSE(map.contains(5));
+  CHECK_THROWS_AS(map.at(5), std::out_of_range);
+}
+
+TEST_CASE("flat_map::lower_bound() finds the first key which is not less", "[flat_map]")
+{
+  // Every size up to 20 to cover all shapes of the branchless search
+  const size_t size = GENERATE(range(size_t(1), size_t(20)));
+
+  flat_map<int, int> map;
+  for (size_t i = 0; i < size; ++i)
+    map.insert(static_cast<int>(10 * i), static_cast<int>(i));
+
+  for (int key = -5; key <= static_cast<int>(10 * size); ++key) {
+    size_t expected = key <= 0 ? 0 : static_cast<size_t>((key + 9) / 10);
+    REQUIRE(map.lower_bound(key) == std::min(expected, size));
+    REQUIRE(map.contains(key) == (key >= 0 && key % 10 == 0 && key < static_cast<int>(10 * size)));
+  }
+}
+
+TEST_CASE("flat_map supports heterogeneous lookup", "[flat_map]")
+{
+  SECTION("with a transparent comparison") {
+    flat_map<std::string, int, std::less<>> map;
+    map.insert("b", 2);
+    map.insert("a", 1);
+
+    CHECK(map.at(std::string_view("b")) == 2);
+    CHECK(map.erase(std::string_view("a")));
+    CHECK(map.size() == 1);
+  }
+  SECTION("by converting the key") {
+    flat_map<std::string, int> map;
+    map.insert("b", 2);
+
+    CHECK(map.contains("b"));
+    CHECK(*map.find("b") == 2);
+  }
+}
+
+
+//----------------------------------------------------------------------
+// Modification
+//
+
+TEST_CASE("flat_map::insert() keeps the keys sorted", "[flat_map]")
+{
+  flat_map<int, int> map;
+  std::map<int, int> expected;
+
+  for (int key : randomKeys(500, 200, 1)) {
+    auto [value, inserted] = map.insert(key, key * 2);
+    REQUIRE(inserted == expected.emplace(key, key * 2).second);
+    REQUIRE(*value == key * 2);
+  }
+
+  requireSameEntries(map, expected);
+}
+
+TEST_CASE("flat_map::insert_or_assign() and operator[] update existing values", "[flat_map]")
+{
+  flat_map<std::string, int> map;
+
+  CHECK(map.insert_or_assign("x", 1));
+  CHECK_FALSE(map.insert_or_assign("x", 2));
+  CHECK(map.at("x") == 2);
+
+  map["y"] += 5;
+  map["x"] += 5;
+  CHECK(map.at("y") == 5);
+  CHECK(map.at("x") == 7);
+}
+
+TEST_CASE("flat_map::insert() keeps the keys and values matched when copying the value throws", "[flat_map]")
+{
+  flat_map<int, throwing_int> map;
+  for (int i = 0; i < 10; ++i)
+    map.insert(i * 2, i * 2);
+
+  throwing_int::failAssignment = true;
+  CHECK_THROWS_AS(map.insert(5, 5), std::runtime_error);
+  CHECK_THROWS_AS(map[7], std::runtime_error);
+  throwing_int::failAssignment = false;
+
+  REQUIRE(map.size() == 10);
+  REQUIRE(map.values().size() == 10);
+  CHECK_FALSE(map.contains(5));
+  for (int i = 0; i < 10; ++i)
+    REQUIRE(map.at(i * 2).value == i * 2);
+
+  map[7].value = 70;
+  CHECK(map.at(7).value == 70);
+  CHECK(map.at(8).value == 8);
+}
+
+TEST_CASE("flat_map::erase() removes entries", "[flat_map]")
+{
+  flat_map<int, int> map;
+  for (int i = 0; i < 10; ++i)
+    map.insert(i, i);
+
+  CHECK(map.erase(0));
+  CHECK(map.erase(5));
+  CHECK(map.erase(9));
+  CHECK_FALSE(map.erase(5));
+
+  std::map<int, int> expected = { {1, 1}, {2, 2}, {3, 3}, {4, 4}, {6, 6}, {7, 7}, {8, 8} };
+  requireSameEntries(map, expected);
+}
+
+TEST_CASE("flat_map bulk construction sorts and keeps the first of repeated keys", "[flat_map]")
+{
+  const std::vector<int> keys = { 5, 3, 5, 1, 3, 9 };
+  const std::vector<int> values = { 50, 30, 51, 10, 31, 90 };
+
+  flat_map<int, int> map(keys.data(), values.data(), keys.size());
+
+  std::map<int, int> expected = { {1, 10}, {3, 30}, {5, 50}, {9, 90} };
+  requireSameEntries(map, expected);
+}
+
+TEST_CASE("flat_map::insert_n() merges a batch with the existing entries", "[flat_map]")
+{
+  const size_t batchSize = GENERATE(size_t(0), size_t(1), size_t(10), size_t(1000));
+
+  flat_map<int, int> map;
+  std::map<int, int> expected;
+
+  for (int key : randomKeys(300, 1000, 2)) {
+    map.insert(key, -key);
+    expected.emplace(key, -key);
+  }
+
+  std::vector<int> keys = randomKeys(batchSize, 1000, 3);
+  std::vector<int> values(batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+    values[i] = static_cast<int>(i);
+
+  size_t inserted = 0;
+  for (size_t i = 0; i < batchSize; ++i)
+    inserted += expected.emplace(keys[i], values[i]).second;
+
+  REQUIRE(map.insert_n(keys.data(), values.data(), batchSize) == inserted);
+  requireSameEntries(map, expected);
+}
+
+TEMPLATE_TEST_CASE("flat_map::insert_n() leaves the map unchanged when copying an entry throws", "[flat_map]",
+                   throwing_int, movable_throwing_int)
+{
+  flat_map<int, TestType> map;
+  map.reserve(20);
+  for (int i = 0; i < 10; i += 2)
+    map.insert(i, i);
+
+  const std::vector<int> keys = { 1, 3, 5, 7, 9 };
+  const std::vector<TestType> values(keys.begin(), keys.end());
+
+  // Fail at the first copy and in the middle of the batch
+  const int failingAssignment = GENERATE(1, 3);
+
+  throwing_int::assignmentsLeft = failingAssignment;
+  CHECK_THROWS_AS(map.insert_n(keys.data(), values.data(), keys.size()), std::runtime_error);
+  throwing_int::assignmentsLeft = 0;
+  throwing_int::failAssignment = false;
+
+  std::map<int, TestType> expected = { {0, 0}, {2, 2}, {4, 4}, {6, 6}, {8, 8} };
+  requireSameEntries(map, expected);
+  CHECK_FALSE(map.contains(5));
+
+  REQUIRE(map.insert_n(keys.data(), values.data(), keys.size()) == 5);
+  for (int i = 0; i < 10; ++i)
+    REQUIRE(map.at(i).value == i);
+}
+
+TEST_CASE("flat_map::for_each_in_range() visits the keys in a half-open range", "[flat_map]")
+{
+  flat_map<int, char> map;
+  for (int i = 0; i < 26; ++i)
+    map.insert(i * 2, static_cast<char>('a' + i));
+
+  std::string visited;
+  map.for_each_in_range(3, 11, [&](int, char value) { visited += value; });
+
+  CHECK(visited == "cdef");
+}
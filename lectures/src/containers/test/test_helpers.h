@@ -0,0 +1,96 @@
+#pragma once
+
+#include "catch2/catch_all.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+
+//----------------------------------------------------------------------
+// Helpers shared by the container tests
+//
+
+/// Checks that the map has exactly the entries of expected, visited in order by for_each
+template <typename Map, typename Key, typename Value>
+void requireSameEntries(const Map& map, const std::map<Key, Value>& expected)
+{
+  REQUIRE(map.size() == expected.size());
+
+  auto it = expected.begin();
+  map.for_each([&](const Key& key, const Value& value) {
+    REQUIRE(it != expected.end());
+    REQUIRE(key == it->first);
+    REQUIRE(value == it->second);
+    ++it;
+  });
+  REQUIRE(it == expected.end());
+}
+
+/// Checks that the map has exactly the entries of expected, in any order
+template <typename Map, typename Key, typename Value>
+void requireSameEntries(const Map& map, const std::unordered_map<Key, Value>& expected)
+{
+  REQUIRE(map.size() == expected.size());
+
+  size_t visited = 0;
+  map.for_each([&](const Key& key, const Value& value) {
+    REQUIRE(expected.at(key) == value);
+    ++visited;
+  });
+  REQUIRE(visited == expected.size());
+}
+
+/// Checks that the sequence has exactly the elements of expected, both by index and by for_each
+template <typename Sequence, typename T>
+void requireSameElements(const Sequence& sequence, const std::deque<T>& expected)
+{
+  REQUIRE(sequence.size() == expected.size());
+
+  for (size_t i = 0; i < expected.size(); ++i)
+    REQUIRE(sequence[i] == expected[i]);
+
+  size_t i = 0;
+  sequence.for_each([&](const T& value) {
+    REQUIRE(i < expected.size());
+    REQUIRE(value == expected[i]);
+    ++i;
+  });
+  REQUIRE(i == expected.size());
+}
+
+/// An int whose assignment throws while failAssignment is set, or once
+/// assignmentsLeft (if positive) counts down to zero
+struct throwing_int {
+  static inline bool failAssignment = false;
+  static inline int assignmentsLeft = 0;
+
+  int value = 0;
+
+  throwing_int() = default;
+  throwing_int(int value) : value(value) {}
+  throwing_int(const throwing_int&) = default;
+
+  throwing_int& operator=(const throwing_int& other)
+  {
+    if (assignmentsLeft > 0 && --assignmentsLeft == 0)
+      failAssignment = true;
+
+    if (failAssignment)
+      throw std::runtime_error("assignment failed");
+
+    value = other.value;
+    return *this;
+  }
+
+  bool operator==(const throwing_int&) const = default;
+};
+
+struct throwing_int_hash {
+  size_t operator()(const throwing_int& key) const
+  {
+    return std::hash<int>()(key.value);
+  }
+};
@@ -0,0 +1,233 @@
+#include "catch2/catch_all.hpp"
+
+#include <cassert>
+
+#include "containers/dynamic_array.h"
+#include "containers/fixed_size_array.h"
+#include "containers/parallel_algorithms.h"
+#include "utils/random.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+using dsa::dynamic_array;
+using dsa::fixed_size_array;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+// Sizes around the grain size, where the algorithms switch between one and several blocks
+size_t generateSize()
+{
+  return GENERATE(size_t(0), size_t(1), dsa::min_grain_size, dsa::min_grain_size + 1, size_t(100'000));
+}
+
+thread_pool& poolWith(size_t threads)
+{
+  static thread_pool one(1);
+  static thread_pool three(3);
+  return threads == 1 ? one : three;
+}
+
+// 0, 1, ..., size - 1 in a pseudo-random order
+dynamic_array<uint64_t> shuffled(size_t size)
+{
+  dynamic_array<uint64_t> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = i;
+
+  uint64_t state = 12345;
+  for (size_t i = size; i > 1; --i)
+    std::swap(arr[i - 1], arr[nextRandom(state) % i]);
+
+  return arr;
+}
+
+
+//----------------------------------------------------------------------
+// parallel_for_each and parallel_transform
+//
+
+TEST_CASE("parallel_for_each() visits every element exactly once", "[parallel]")
+{
+  const size_t size = generateSize();
+  thread_pool& pool = poolWith(GENERATE(1, 3));
+
+  dynamic_array<int> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = static_cast<int>(i);
+
+  dsa::parallel_for_each(arr, [](int& x) { x *= 2; }, pool);
+
+  for (size_t i = 0; i < size; ++i)
+    REQUIRE(arr[i] == static_cast<int>(2 * i));
+}
+
+TEST_CASE("parallel_transform() writes the results to the output", "[parallel]")
+{
+  const size_t size = generateSize();
+  thread_pool& pool = poolWith(GENERATE(1, 3));
+
+  fixed_size_array<int> input(size);
+  for (size_t i = 0; i < size; ++i)
+    input[i] = static_cast<int>(i);
+
+  dynamic_array<std::string> output(size);
+  dsa::parallel_transform(input, output, [](int x) { return std::to_string(x); }, pool);
+
+  for (size_t i = 0; i < size; ++i)
+    REQUIRE(output[i] == std::to_string(i));
+}
+
+TEST_CASE("Small inputs are processed on the calling thread", "[parallel]")
+{
+  thread_pool& pool = poolWith(3);
+  const std::thread::id caller = std::this_thread::get_id();
+
+  dynamic_array<int> arr(dsa::min_grain_size);
+  for (size_t i = 0; i < arr.size(); ++i)
+    arr[i] = static_cast<int>(i);
+
+  size_t onOtherThreads = 0;
+  auto countOtherThreads = [&]() {
+    if (std::this_thread::get_id() != caller)
+      ++onOtherThreads;
+  };
+
+  dsa::parallel_for_each(arr, [&](int&) { countOtherThreads(); }, pool);
+  dsa::parallel_transform(arr, arr, [&](int x) { countOtherThreads(); return x; }, pool);
+  dsa::parallel_reduce(arr, 0, [&](int a, int b) { countOtherThreads(); return a + b; },
+                       dsa::reduction_order::any, pool);
+
+  CHECK(onOtherThreads == 0);
+}
+
+TEST_CASE("parallel_transform() throws if the output is too small", "[parallel]")
+{
+  dynamic_array<int> input(10);
+  dynamic_array<int> output(9);
+
+  REQUIRE_THROWS_AS(dsa::parallel_transform(input, output, [](int x) { return x; }), std::invalid_argument);
+}
+
+
+//----------------------------------------------------------------------
+// parallel_reduce
+//
+
+TEST_CASE("parallel_reduce() combines all elements", "[parallel]")
+{
+  const size_t size = generateSize();
+  thread_pool& pool = poolWith(GENERATE(1, 3));
+  const dsa::reduction_order order = GENERATE(dsa::reduction_order::any, dsa::reduction_order::deterministic);
+
+  dynamic_array<uint64_t> arr = shuffled(size);
+
+  uint64_t sum = dsa::parallel_reduce(arr, uint64_t(7), std::plus<>(), order, pool);
+  REQUIRE(sum == 7 + size * (size - (size > 0)) / 2);
+}
+
+TEST_CASE("parallel_reduce() keeps the order of a non-commutative operation", "[parallel]")
+{
+  thread_pool& pool = poolWith(3);
+  const size_t size = 10'000;
+
+  dynamic_array<std::string> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = std::string(1, static_cast<char>('a' + i % 26));
+
+  std::string expected = ">";
+  for (size_t i = 0; i < size; ++i)
+    expected += arr[i];
+
+  REQUIRE(dsa::parallel_reduce(arr, std::string(">"), std::plus<>(), dsa::reduction_order::any, pool) == expected);
+}
+
+TEST_CASE("parallel_reduce() with a deterministic order gives the same result with any number of threads", "[parallel]")
+{
+  const size_t size = 1'000'000;
+  dynamic_array<double> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = 1.0 / (1.0 + static_cast<double>(i));
+
+  double withOne = dsa::parallel_reduce(arr, 0.0, std::plus<>(), dsa::reduction_order::deterministic, poolWith(1));
+  double withThree = dsa::parallel_reduce(arr, 0.0, std::plus<>(), dsa::reduction_order::deterministic, poolWith(3));
+
+  REQUIRE(withOne == withThree);
+}
+
+
+//----------------------------------------------------------------------
+// parallel_scan
+//
+
+TEST_CASE("parallel_scan() computes inclusive prefix sums", "[parallel]")
+{
+  const size_t size = generateSize();
+  thread_pool& pool = poolWith(GENERATE(1, 3));
+
+  dynamic_array<uint64_t> input(size);
+  for (size_t i = 0; i < size; ++i)
+    input[i] = i % 10;
+
+  SECTION("into another container") {
+    dynamic_array<uint64_t> output(size);
+    dsa::parallel_scan(input, output, uint64_t(100), std::plus<>(), pool);
+
+    uint64_t expected = 100;
+    for (size_t i = 0; i < size; ++i) {
+      expected += i % 10;
+      REQUIRE(output[i] == expected);
+    }
+  }
+  SECTION("in place") {
+    dsa::parallel_scan(input, input, uint64_t(0), std::plus<>(), pool);
+
+    uint64_t expected = 0;
+    for (size_t i = 0; i < size; ++i) {
+      expected += i % 10;
+      REQUIRE(input[i] == expected);
+    }
+  }
+}
+
+
+//----------------------------------------------------------------------
+// parallel_sort
+//
+
+TEST_CASE("parallel_sort() sorts the elements", "[parallel]")
+{
+  const size_t size = generateSize();
+  thread_pool& pool = poolWith(GENERATE(1, 3));
+
+  dynamic_array<uint64_t> arr = shuffled(size);
+
+  SECTION("in ascending order") {
+    dsa::parallel_sort(arr, std::less<>(), pool);
+
+    for (size_t i = 0; i < size; ++i)
+      REQUIRE(arr[i] == i);
+  }
+  SECTION("with a custom comparison") {
+    dsa::parallel_sort(arr, std::greater<>(), pool);
+
+    for (size_t i = 0; i < size; ++i)
+      REQUIRE(arr[i] == size - 1 - i);
+  }
+}
+
+TEST_CASE("parallel_sort() handles many equal elements", "[parallel]")
+{
+  const size_t size = 50'000;
+  fixed_size_array<std::string> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = std::to_string((i * 7919) % 13);
+
+  dsa::parallel_sort(arr, std::less<>(), poolWith(3));
+
+  for (size_t i = 1; i < size; ++i)
+    REQUIRE(arr[i - 1] <= arr[i]);
+}
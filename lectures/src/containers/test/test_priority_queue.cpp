@@ -0,0 +1,284 @@
+#include "catch2/catch_all.hpp"
+
+#include "containers/priority_queue.h"
+#include "test_helpers.h"
+#include "utils/random.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using dsa::indexed_priority_queue;
+using dsa::priority_queue;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+namespace {
+
+// Pseudo-random values with many duplicates
+std::vector<int> randomValues(size_t count)
+{
+  std::vector<int> values(count);
+  uint64_t state = 7;
+  for (int& value : values)
+    value = static_cast<int>(nextRandom(state) % 1000);
+  return values;
+}
+
+// Pops all elements, which must come out in the order given by less
+template <typename Queue, typename Compare>
+std::vector<int> drain(Queue& queue, Compare less)
+{
+  std::vector<int> result;
+  while (!queue.empty()) {
+    if (!result.empty())
+      REQUIRE_FALSE(less(result.back(), queue.top()));
+    result.push_back(queue.top());
+    queue.pop();
+  }
+  return result;
+}
+
+std::vector<int> sortedDescending(std::vector<int> values)
+{
+  std::sort(values.begin(), values.end(), std::greater<>());
+  return values;
+}
+
+}
+
+
+//----------------------------------------------------------------------
+// priority_queue
+//
+
+TEMPLATE_TEST_CASE_SIG("priority_queue returns the elements from the largest", "[priority_queue]",
+  ((size_t Arity), Arity), 2, 3, 4, 8)
+{
+  const size_t count = GENERATE(size_t(1), size_t(5), size_t(1000));
+  const std::vector<int> values = randomValues(count);
+
+  SECTION("when pushed one by one") {
+    priority_queue<int, std::less<int>, Arity> queue;
+    for (int value : values)
+      queue.push(value);
+
+    REQUIRE(queue.size() == count);
+    REQUIRE(drain(queue, std::less<>()) == sortedDescending(values));
+  }
+  SECTION("when built from a range") {
+    priority_queue<int, std::less<int>, Arity> queue(values.data(), values.size());
+
+    REQUIRE(queue.size() == count);
+    REQUIRE(drain(queue, std::less<>()) == sortedDescending(values));
+  }
+  SECTION("when added with push_n") {
+    priority_queue<int, std::less<int>, Arity> queue;
+    queue.push(500);
+    queue.push_n(values.data(), values.size());     // rebuilds the heap
+    queue.push_n(values.data(), 1);                 // sifts up
+
+    std::vector<int> all = values;
+    all.push_back(500);
+    all.push_back(values[0]);
+
+    REQUIRE(drain(queue, std::less<>()) == sortedDescending(all));
+  }
+}
+
+TEST_CASE("priority_queue with std::greater returns the smallest element first", "[priority_queue]")
+{
+  priority_queue<std::string, std::greater<std::string>> queue;
+  for (const char* word : { "pear", "apple", "fig", "banana" })
+    queue.push(word);
+
+  CHECK(queue.top() == "apple");
+  queue.pop();
+  CHECK(queue.top() == "banana");
+}
+
+TEST_CASE("priority_queue::push_pop() returns the largest of the queue and the value", "[priority_queue]")
+{
+  priority_queue<int> queue;
+
+  SECTION("an empty queue returns the value") {
+    CHECK(queue.push_pop(5) == 5);
+    CHECK(queue.empty());
+  }
+  SECTION("a value larger than the top is returned right away") {
+    queue.push(3);
+    queue.push(1);
+    CHECK(queue.push_pop(7) == 7);
+    CHECK(queue.size() == 2);
+    CHECK(queue.top() == 3);
+  }
+  SECTION("a smaller value replaces the top") {
+    queue.push(3);
+    queue.push(1);
+    CHECK(queue.push_pop(2) == 3);
+    CHECK(queue.size() == 2);
+    CHECK(queue.top() == 2);
+  }
+}
+
+TEST_CASE("priority_queue::push_pop() keeps the k smallest elements", "[priority_queue]")
+{
+  const std::vector<int> values = randomValues(5000);
+  const size_t k = 10;
+
+  priority_queue<int> largestOnTop(values.data(), k);
+  for (size_t i = k; i < values.size(); ++i)
+    largestOnTop.push_pop(values[i]);
+
+  std::vector<int> expected = values;
+  std::sort(expected.begin(), expected.end());
+  expected.resize(k);
+
+  std::vector<int> kept = drain(largestOnTop, std::less<>());
+  std::reverse(kept.begin(), kept.end());
+
+  REQUIRE(kept == expected);
+}
+
+TEST_CASE("priority_queue::push_n() leaves the queue unchanged when copying a value throws", "[priority_queue]")
+{
+  auto less = [](const throwing_int& a, const throwing_int& b) { return a.value < b.value; };
+  priority_queue<throwing_int, decltype(less)> queue;
+  queue.reserve(8); // so that push_n() does not have to reallocate
+  for (int i = 0; i < 4; ++i)
+    queue.push(i);
+
+  const std::vector<throwing_int> values = { -1, -2, -3, -4 };
+
+  throwing_int::assignmentsLeft = 3;
+  CHECK_THROWS_AS(queue.push_n(values.data(), values.size()), std::runtime_error);
+  throwing_int::assignmentsLeft = 0;
+  throwing_int::failAssignment = false;
+
+  REQUIRE(queue.size() == 4);
+  CHECK(queue.top().value == 3);
+
+  queue.push_n(values.data(), values.size());
+  for (int expected = 3; expected >= -4; --expected) {
+    REQUIRE(queue.top().value == expected);
+    queue.pop();
+  }
+  CHECK(queue.empty());
+}
+
+TEST_CASE("priority_queue throws on an empty queue", "[priority_queue]")
+{
+  priority_queue<int> queue;
+
+  CHECK_THROWS_AS(queue.top(), priority_queue<int>::EmptyQueueException);
+  CHECK_THROWS_AS(queue.pop(), priority_queue<int>::EmptyQueueException);
+}
+
+TEST_CASE("priority_queue::clear() and swap()", "[priority_queue]")
+{
+  priority_queue<int> first;
+  priority_queue<int> second;
+  first.push(1);
+  first.push(2);
+
+  first.swap(second);
+  CHECK(first.empty());
+  CHECK(second.top() == 2);
+
+  second.clear();
+  CHECK(second.empty());
+}
+
+
+//----------------------------------------------------------------------
+// indexed_priority_queue
+//
+
+TEST_CASE("indexed_priority_queue returns the items from the smallest priority", "[indexed_priority_queue]")
+{
+  const std::vector<int> priorities = randomValues(1000);
+  indexed_priority_queue<int> queue;
+
+  for (size_t i = 0; i < priorities.size(); ++i)
+    queue.push(i, priorities[i]);
+
+  REQUIRE(queue.size() == priorities.size());
+
+  int previous = -1;
+  while (!queue.empty()) {
+    size_t index = queue.top_index();
+    REQUIRE(queue.top_priority() == priorities[index]);
+    REQUIRE(queue.top_priority() >= previous);
+    previous = queue.top_priority();
+
+    REQUIRE(queue.pop() == index);
+    REQUIRE_FALSE(queue.contains(index));
+  }
+}
+
+TEST_CASE("indexed_priority_queue::decrease_key() moves an item to the top", "[indexed_priority_queue]")
+{
+  indexed_priority_queue<double> queue;
+  queue.push(10, 5.0);
+  queue.push(3, 2.0);
+  queue.push(7, 9.0);
+
+  REQUIRE(queue.top_index() == 3);
+
+  queue.decrease_key(7, 1.0);
+  CHECK(queue.top_index() == 7);
+  CHECK(queue.priority(7) == 1.0);
+
+  SECTION("the priority cannot be increased") {
+    CHECK_THROWS_AS(queue.decrease_key(10, 6.0), std::invalid_argument);
+  }
+  SECTION("change_priority() can move an item in both directions") {
+    queue.change_priority(7, 20.0);
+    CHECK(queue.top_index() == 3);
+    queue.change_priority(10, 0.5);
+    CHECK(queue.top_index() == 10);
+  }
+}
+
+TEST_CASE("indexed_priority_queue::erase() removes any item", "[indexed_priority_queue]")
+{
+  indexed_priority_queue<int, std::greater<int>, 2> queue;
+  for (size_t i = 0; i < 100; ++i)
+    queue.push(i, static_cast<int>((i * 37) % 100));
+
+  for (size_t i = 0; i < 100; i += 3)
+    queue.erase(i);
+
+  CHECK_FALSE(queue.contains(0));
+  CHECK(queue.contains(1));
+
+  int previous = -1;
+  while (!queue.empty()) {
+    size_t index = queue.pop();
+    REQUIRE(index % 3 != 0);
+    REQUIRE(static_cast<int>((index * 37) % 100) > previous);
+    previous = static_cast<int>((index * 37) % 100);
+  }
+}
+
+TEST_CASE("indexed_priority_queue rejects invalid items", "[indexed_priority_queue]")
+{
+  indexed_priority_queue<int> queue;
+  queue.push(2, 1);
+
+  CHECK_THROWS_AS(queue.push(2, 5), std::invalid_argument);
+  CHECK_THROWS_AS(queue.priority(1), std::out_of_range);
+  CHECK_THROWS_AS(queue.decrease_key(100, 0), std::out_of_range);
+  CHECK_THROWS_AS(queue.erase(0), std::out_of_range);
+
+  queue.clear();
+  CHECK(queue.empty());
+  CHECK_FALSE(queue.contains(2));
+  CHECK_THROWS_AS(queue.pop(), indexed_priority_queue<int>::EmptyQueueException);
+  CHECK_THROWS_AS(queue.top_index(), indexed_priority_queue<int>::EmptyQueueException);
+}
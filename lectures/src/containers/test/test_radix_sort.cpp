@@ -0,0 +1,191 @@
+#include "catch2/catch_all.hpp"
+
+#include <cassert>
+
+#include "containers/dynamic_array.h"
+#include "containers/radix_sort.h"
+#include "utils/random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+using dsa::dynamic_array;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+namespace {
+
+template <typename T>
+dynamic_array<T> randomArray(size_t size)
+{
+  uint64_t state = 42;
+  dynamic_array<T> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = static_cast<T>(nextRandom64(state));
+  return arr;
+}
+
+template <typename T>
+bool isSorted(const dynamic_array<T>& arr)
+{
+  return std::is_sorted(arr.data(), arr.data() + arr.size());
+}
+
+template <typename T>
+bool hasSameElements(const dynamic_array<T>& sorted, const dynamic_array<T>& original)
+{
+  dynamic_array<T> expected = original;
+  std::sort(expected.data(), expected.data() + expected.size());
+  return std::equal(sorted.data(), sorted.data() + sorted.size(), expected.data(), expected.data() + expected.size());
+}
+
+thread_pool& radixPool()
+{
+  static thread_pool pool(3);
+  return pool;
+}
+
+struct record {
+  int key = 0;
+  size_t position = 0;
+};
+
+}
+
+
+//----------------------------------------------------------------------
+// Integral keys
+//
+
+TEMPLATE_TEST_CASE("radix_sort() sorts integers", "[radix_sort]", uint8_t, int16_t, uint32_t, int, int64_t, uint64_t)
+{
+  const size_t size = GENERATE(size_t(0), size_t(1), size_t(2), size_t(1000), size_t(100'000));
+  thread_pool* pool = GENERATE(static_cast<thread_pool*>(nullptr), &radixPool());
+
+  const dynamic_array<TestType> original = randomArray<TestType>(size);
+  dynamic_array<TestType> arr = original;
+
+  SECTION("with 8-bit digits") {
+    dsa::radix_sort<8>(arr, pool);
+  }
+  SECTION("with 11-bit digits") {
+    dsa::radix_sort<11>(arr, pool);
+  }
+  SECTION("with 16-bit digits") {
+    dsa::radix_sort<16>(arr, pool);
+  }
+
+  REQUIRE(isSorted(arr));
+  REQUIRE(hasSameElements(arr, original));
+}
+
+TEST_CASE("radix_sort() puts negative numbers before positive ones", "[radix_sort]")
+{
+  dynamic_array<int> arr;
+  for (int x : { 5, -1, std::numeric_limits<int>::max(), 0, std::numeric_limits<int>::min(), -300, 2 })
+    arr.push_back(x);
+
+  dsa::radix_sort(arr);
+
+  const int expected[] = { std::numeric_limits<int>::min(), -300, -1, 0, 2, 5, std::numeric_limits<int>::max() };
+  REQUIRE(std::equal(arr.data(), arr.data() + arr.size(), std::begin(expected), std::end(expected)));
+}
+
+TEST_CASE("radix_sort() handles keys which differ only in some digits", "[radix_sort]")
+{
+  // Only the second lowest byte varies, so all other passes are skipped
+  dynamic_array<uint64_t> arr(1000);
+  for (size_t i = 0; i < arr.size(); ++i)
+    arr[i] = 0xABCD'0000'0000'0000ULL | (((i * 37) % 256) << 8);
+
+  dynamic_array<uint64_t> original = arr;
+  dsa::radix_sort(arr);
+
+  REQUIRE(isSorted(arr));
+  REQUIRE(hasSameElements(arr, original));
+}
+
+
+//----------------------------------------------------------------------
+// Floating-point keys
+//
+
+TEMPLATE_TEST_CASE("radix_sort() sorts floating-point numbers", "[radix_sort]", float, double)
+{
+  const size_t size = GENERATE(size_t(10), size_t(100'000));
+  thread_pool* pool = GENERATE(static_cast<thread_pool*>(nullptr), &radixPool());
+
+  uint64_t state = 42;
+  dynamic_array<TestType> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = static_cast<TestType>(static_cast<int64_t>(nextRandom64(state) % 2'000'001) - 1'000'000) / TestType(7);
+
+  const dynamic_array<TestType> original = arr;
+  dsa::radix_sort(arr, pool);
+
+  REQUIRE(isSorted(arr));
+  REQUIRE(hasSameElements(arr, original));
+}
+
+TEST_CASE("radix_sort() orders infinities, zeros and NaNs", "[radix_sort]")
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  dynamic_array<double> arr;
+  for (double x : { 1.5, nan, -inf, 0.0, -nan, inf, -0.0, -2.0, std::numeric_limits<double>::denorm_min() })
+    arr.push_back(x);
+
+  dsa::radix_sort(arr);
+
+  REQUIRE(arr[0] == -inf);
+  REQUIRE(arr[1] == -2.0);
+  REQUIRE((arr[2] == 0.0 && std::signbit(arr[2])));
+  REQUIRE((arr[3] == 0.0 && !std::signbit(arr[3])));
+  REQUIRE(arr[4] == std::numeric_limits<double>::denorm_min());
+  REQUIRE(arr[5] == 1.5);
+  REQUIRE(arr[6] == inf);
+  REQUIRE(std::isnan(arr[7]));
+  REQUIRE(std::isnan(arr[8]));
+}
+
+
+//----------------------------------------------------------------------
+// Key extraction
+//
+
+TEST_CASE("radix_sort() with a key function is stable", "[radix_sort]")
+{
+  const size_t size = GENERATE(size_t(1000), size_t(100'000));
+  thread_pool* pool = GENERATE(static_cast<thread_pool*>(nullptr), &radixPool());
+
+  uint64_t state = 42;
+  dynamic_array<record> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = record{ static_cast<int>(nextRandom64(state) % 100) - 50, i };
+
+  dsa::radix_sort(arr, [](const record& r) { return r.key; }, pool);
+
+  for (size_t i = 1; i < size; ++i) {
+    REQUIRE(arr[i - 1].key <= arr[i].key);
+    if (arr[i - 1].key == arr[i].key)
+      REQUIRE(arr[i - 1].position < arr[i].position);
+  }
+}
+
+TEST_CASE("radix_sort() moves elements which are not trivially copyable", "[radix_sort]")
+{
+  dynamic_array<std::string> arr;
+  for (int i = 0; i < 500; ++i)
+    arr.push_back(std::to_string((i * 7919) % 500));
+
+  dsa::radix_sort(arr, [](const std::string& s) { return std::stoi(s); });
+
+  for (int i = 0; i < 500; ++i)
+    REQUIRE(arr[i] == std::to_string(i));
+}
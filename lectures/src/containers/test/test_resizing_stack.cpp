@@ -0,0 +1,193 @@
+#include "catch2/catch_all.hpp"
+
+#include "containers/resizing_stack.h"
+#include "test_helpers.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using dsa::resizing_stack;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+// The bulk operations use memcpy for int and element-wise moves for std::string
+
+template <typename T>
+T valueFor(int i);
+
+template <>
+int valueFor<int>(int i)
+{
+  return i;
+}
+
+template <>
+std::string valueFor<std::string>(int i)
+{
+  return "value #" + std::to_string(i);
+}
+
+
+//----------------------------------------------------------------------
+// Adding and removing elements
+//
+
+TEST_CASE("resizing_stack() constructs an empty stack", "[resizing_stack]")
+{
+  resizing_stack<int> stack;
+
+  CHECK(stack.empty());
+  CHECK(stack.size() == 0);
+  CHECK(stack.capacity() == 0);
+}
+
+TEST_CASE("resizing_stack::push() and pop() work in LIFO order", "[resizing_stack]")
+{
+  resizing_stack<int> stack;
+
+  for (int i = 0; i < 1000; ++i) {
+    stack.push(i);
+    REQUIRE(stack.top() == i);
+  }
+
+  REQUIRE(stack.size() == 1000);
+
+  for (int i = 999; i >= 0; --i) {
+    REQUIRE(stack.top() == i);
+    stack.pop();
+  }
+
+  REQUIRE(stack.empty());
+}
+
+TEST_CASE("resizing_stack::top() and pop() throw when the stack is empty", "[resizing_stack]")
+{
+  resizing_stack<int> stack;
+  const resizing_stack<int>& cref = stack;
+
+  REQUIRE_THROWS_AS(stack.top(), resizing_stack<int>::EmptyStackException);
+  REQUIRE_THROWS_AS(cref.top(), resizing_stack<int>::EmptyStackException);
+  REQUIRE_THROWS_AS(stack.pop(), resizing_stack<int>::EmptyStackException);
+}
+
+
+//----------------------------------------------------------------------
+// Bulk operations
+//
+
+TEMPLATE_TEST_CASE("resizing_stack::push_n() and pop_n() transfer whole spans", "[resizing_stack]", int, std::string)
+{
+  TestType values[100];
+  for (int i = 0; i < 100; ++i)
+    values[i] = valueFor<TestType>(i);
+
+  resizing_stack<TestType> stack;
+  stack.push(valueFor<TestType>(-1));
+  stack.push_n(values, 100);
+
+  REQUIRE(stack.size() == 101);
+  REQUIRE(stack.top() == values[99]);
+
+  SECTION("pop_n() returns the span in the order it was pushed") {
+    TestType out[100];
+
+    REQUIRE(stack.pop_n(out, 100) == 100);
+    REQUIRE(stack.size() == 1);
+    REQUIRE(stack.top() == valueFor<TestType>(-1));
+
+    for (int i = 0; i < 100; ++i)
+      REQUIRE(out[i] == values[i]);
+  }
+  SECTION("pop_n() removes at most size() elements") {
+    TestType out[200];
+
+    REQUIRE(stack.pop_n(out, 200) == 101);
+    REQUIRE(stack.empty());
+    REQUIRE(out[0] == valueFor<TestType>(-1));
+    REQUIRE(out[100] == values[99]);
+  }
+}
+
+TEST_CASE("resizing_stack::push_n() with zero elements does nothing", "[resizing_stack]")
+{
+  resizing_stack<int> stack;
+  int out;
+
+  stack.push_n(nullptr, 0);
+
+  REQUIRE(stack.empty());
+  REQUIRE(stack.pop_n(&out, 1) == 0);
+}
+
+
+//----------------------------------------------------------------------
+// Capacity
+//
+
+TEST_CASE("resizing_stack::push_n() leaves the stack unchanged when copying a value throws", "[resizing_stack]")
+{
+  // Leave room for the values, so that push_n() does not have to reallocate
+  resizing_stack<throwing_int> stack;
+  for (int i = 0; i < 8; ++i)
+    stack.push(i);
+  for (int i = 0; i < 4; ++i)
+    stack.pop();
+
+  const std::vector<throwing_int> values = { 10, 11, 12, 13 };
+
+  throwing_int::assignmentsLeft = 3;
+  CHECK_THROWS_AS(stack.push_n(values.data(), values.size()), std::runtime_error);
+  throwing_int::assignmentsLeft = 0;
+  throwing_int::failAssignment = false;
+
+  REQUIRE(stack.size() == 4);
+  CHECK(stack.top().value == 3);
+
+  stack.push_n(values.data(), values.size());
+  REQUIRE(stack.size() == 8);
+  CHECK(stack.top().value == 13);
+}
+
+TEST_CASE("resizing_stack shrinks only when it becomes a quarter full", "[resizing_stack]")
+{
+  resizing_stack<int> stack;
+
+  for (int i = 0; i < 1024; ++i)
+    stack.push(i);
+
+  const size_t fullCapacity = stack.capacity();
+  REQUIRE(fullCapacity == 1024);
+
+  SECTION("popping down to half does not shrink the buffer") {
+    while (stack.size() > fullCapacity / 2)
+      stack.pop();
+
+    REQUIRE(stack.capacity() == fullCapacity);
+  }
+  SECTION("popping down to a quarter halves the buffer and keeps the elements") {
+    while (stack.size() > fullCapacity / 4)
+      stack.pop();
+
+    REQUIRE(stack.capacity() == fullCapacity / 2);
+
+    for (int i = static_cast<int>(stack.size()) - 1; i >= 0; --i) {
+      REQUIRE(stack.top() == i);
+      stack.pop();
+    }
+  }
+  SECTION("a push and a pop at the boundary do not reallocate") {
+    while (stack.size() > fullCapacity / 4)
+      stack.pop();
+
+    const size_t capacity = stack.capacity();
+
+    for (int i = 0; i < 100; ++i) {
+      stack.push(i);
+      stack.pop();
+      REQUIRE(stack.capacity() == capacity);
+    }
+  }
+}
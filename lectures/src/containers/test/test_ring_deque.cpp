@@ -0,0 +1,222 @@
+#include "catch2/catch_all.hpp"
+
+#include "containers/ring_deque.h"
+
+#include <string>
+
+using dsa::ring_deque;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+// The deque must contain first, first + 1, ..., first + count - 1
+bool containsSequence(const ring_deque<int>& deque, int first, size_t count)
+{
+  if (deque.size() != count)
+    return false;
+
+  for (size_t i = 0; i < count; ++i) {
+    if (deque[i] != first + static_cast<int>(i))
+      return false;
+  }
+
+  return true;
+}
+
+// Makes the elements of the deque wrap around the end of its buffer
+void rotate(ring_deque<int>& deque, size_t steps)
+{
+  for (size_t i = 0; i < steps; ++i) {
+    int value = deque.front();
+    deque.pop_front();
+    deque.push_back(value);
+  }
+}
+
+
+//----------------------------------------------------------------------
+// Adding and removing elements
+//
+
+TEST_CASE("ring_deque() constructs an empty deque", "[ring_deque]")
+{
+  ring_deque<int> deque;
+
+  CHECK(deque.empty());
+  CHECK(deque.size() == 0);
+  CHECK(deque.capacity() == 0);
+}
+
+TEST_CASE("ring_deque can be used at both ends", "[ring_deque]")
+{
+  ring_deque<int> deque;
+
+  for (int i = 0; i < 100; ++i) {
+    deque.push_back(i);
+    deque.push_front(-i - 1);
+  }
+
+  REQUIRE(containsSequence(deque, -100, 200));
+  REQUIRE(deque.front() == -100);
+  REQUIRE(deque.back() == 99);
+
+  deque.pop_front();
+  deque.pop_back();
+
+  REQUIRE(containsSequence(deque, -99, 198));
+}
+
+TEST_CASE("ring_deque capacity is a power of two", "[ring_deque]")
+{
+  ring_deque<int> deque;
+
+  deque.reserve(100);
+  REQUIRE(deque.capacity() == 128);
+
+  for (int i = 0; i < 129; ++i)
+    deque.push_back(i);
+  REQUIRE(deque.capacity() == 256);
+}
+
+TEST_CASE("ring_deque keeps the order of the elements when growing while wrapped", "[ring_deque]")
+{
+  ring_deque<int> deque;
+  deque.reserve(16);
+
+  for (int i = 0; i < 16; ++i)
+    deque.push_back(i);
+  rotate(deque, 5);
+
+  for (int i = 16; i < 21; ++i)
+    deque.push_back(i);
+
+  // 5, 6, ..., 15, 0, 1, ..., 4, 16, ..., 20
+  REQUIRE(deque.size() == 21);
+  for (int i = 0; i < 11; ++i)
+    REQUIRE(deque[i] == i + 5);
+  for (int i = 11; i < 16; ++i)
+    REQUIRE(deque[i] == i - 11);
+  for (int i = 16; i < 21; ++i)
+    REQUIRE(deque[i] == i);
+}
+
+TEST_CASE("ring_deque throws when an element of an empty deque is accessed", "[ring_deque]")
+{
+  ring_deque<int> deque;
+  const ring_deque<int>& cref = deque;
+
+  REQUIRE_THROWS_AS(deque.front(), ring_deque<int>::EmptyDequeException);
+  REQUIRE_THROWS_AS(cref.back(), ring_deque<int>::EmptyDequeException);
+  REQUIRE_THROWS_AS(deque.pop_front(), ring_deque<int>::EmptyDequeException);
+  REQUIRE_THROWS_AS(deque.pop_back(), ring_deque<int>::EmptyDequeException);
+  REQUIRE_THROWS_AS(deque.at(0), std::out_of_range);
+}
+
+
+//----------------------------------------------------------------------
+// Bulk operations
+//
+
+TEST_CASE("ring_deque::push_back_n() and pop_front_n() work across the end of the buffer", "[ring_deque]")
+{
+  ring_deque<int> deque;
+  deque.reserve(64);
+
+  for (int i = 0; i < 60; ++i)
+    deque.push_back(i);
+
+  int out[64];
+  REQUIRE(deque.pop_front_n(out, 40) == 40);
+  for (int i = 0; i < 40; ++i)
+    REQUIRE(out[i] == i);
+
+  // The remaining 40..59 are at the end of the buffer, the new values wrap around
+  int values[40];
+  for (int i = 0; i < 40; ++i)
+    values[i] = 60 + i;
+
+  deque.push_back_n(values, 40);
+
+  REQUIRE(deque.capacity() == 64);
+  REQUIRE(containsSequence(deque, 40, 60));
+
+  REQUIRE(deque.pop_front_n(out, 64) == 60);
+  REQUIRE(deque.empty());
+  for (int i = 0; i < 60; ++i)
+    REQUIRE(out[i] == 40 + i);
+}
+
+TEST_CASE("ring_deque bulk operations work with non-trivial types", "[ring_deque]")
+{
+  ring_deque<std::string> deque;
+  std::string values[20];
+
+  for (int i = 0; i < 20; ++i)
+    values[i] = "value #" + std::to_string(i);
+
+  deque.push_back_n(values, 20);
+  deque.push_back_n(values, 20);
+
+  std::string out[40];
+  REQUIRE(deque.pop_front_n(out, 40) == 40);
+
+  for (int i = 0; i < 40; ++i)
+    REQUIRE(out[i] == values[i % 20]);
+}
+
+
+//----------------------------------------------------------------------
+// Capacity
+//
+
+TEST_CASE("ring_deque shrinks only when it becomes a quarter full", "[ring_deque]")
+{
+  ring_deque<int> deque;
+
+  for (int i = 0; i < 256; ++i)
+    deque.push_back(i);
+  rotate(deque, 100);
+
+  REQUIRE(deque.capacity() == 256);
+
+  SECTION("popping down to half does not shrink the buffer") {
+    while (deque.size() > 128)
+      deque.pop_front();
+
+    REQUIRE(deque.capacity() == 256);
+  }
+  SECTION("popping down to a quarter halves the buffer and keeps the order") {
+    while (deque.size() > 64)
+      deque.pop_front();
+
+    REQUIRE(deque.capacity() == 128);
+    REQUIRE(containsSequence(deque, 36, 64));
+  }
+}
+
+TEST_CASE("ring_deque::shrink_to_fit() keeps the elements", "[ring_deque]")
+{
+  ring_deque<int> deque;
+  deque.reserve(1024);
+
+  for (int i = 0; i < 20; ++i)
+    deque.push_back(i);
+
+  deque.shrink_to_fit();
+
+  REQUIRE(deque.capacity() == 32);
+  REQUIRE(containsSequence(deque, 0, 20));
+}
+
+TEST_CASE("ring_deque can be moved", "[ring_deque]")
+{
+  ring_deque<int> deque;
+  for (int i = 0; i < 10; ++i)
+    deque.push_back(i);
+
+  ring_deque<int> moved(std::move(deque));
+
+  REQUIRE(deque.empty());
+  REQUIRE(containsSequence(moved, 0, 10));
+}
@@ -0,0 +1,319 @@
+#include "catch2/catch_all.hpp"
+
+#include <cassert>
+
+#include "containers/segmented_array.h"
+#include "test_helpers.h"
+#include "utils/random.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+using dsa::segmented_array;
+
+//----------------------------------------------------------------------
+// Helper functions
+//
+
+namespace {
+
+// Small blocks, so that even small tests use many of them
+template <typename T>
+using small_array = segmented_array<T, 8>;
+
+}
+
+
+//----------------------------------------------------------------------
+// Access
+//
+
+TEST_CASE("segmented_array() constructs an empty array", "[segmented_array]")
+{
+  segmented_array<int> arr;
+
+  CHECK(arr.empty());
+  CHECK(arr.capacity() == 0);
+  CHECK(arr.block_count() == 0);
+  CHECK_THROWS_AS(arr.at(0), std::out_of_range);
+  CHECK_THROWS_AS(arr.front(), segmented_array<int>::EmptyArrayException);
+  CHECK_THROWS_AS(arr.back(), segmented_array<int>::EmptyArrayException);
+  CHECK_THROWS_AS(arr.pop_back(), segmented_array<int>::EmptyArrayException);
+  CHECK_THROWS_AS(arr.pop_front(), segmented_array<int>::EmptyArrayException);
+}
+
+TEST_CASE("segmented_array blocks take about 4 KiB by default", "[segmented_array]")
+{
+  CHECK(segmented_array<int>::block_size() == 1024);
+  CHECK(segmented_array<uint64_t>::block_size() == 512);
+  CHECK(segmented_array<char[1000]>::block_size() == 16);
+}
+
+TEST_CASE("segmented_array::at() checks the index", "[segmented_array]")
+{
+  small_array<int> arr;
+  for (int i = 0; i < 20; ++i)
+    arr.push_back(i);
+
+  CHECK(arr.at(0) == 0);
+  CHECK(arr.at(19) == 19);
+  CHECK_THROWS_AS(arr.at(20), std::out_of_range);
+}
+
+
+//----------------------------------------------------------------------
+// Modification
+//
+
+TEST_CASE("segmented_array behaves like std::deque", "[segmented_array]")
+{
+  small_array<int> arr;
+  std::deque<int> expected;
+
+  uint64_t state = 1;
+  for (int step = 0; step < 20'000; ++step) {
+    // Grow for a while, then shrink for a while, so that blocks are added
+    // and released at both ends
+    bool growing = (step / 2000) % 2 == 0;
+    uint64_t operation = nextRandom(state) % 4;
+
+    if (growing || expected.empty()) {
+      if (operation < 2) {
+        arr.push_back(step);
+        expected.push_back(step);
+      }
+      else {
+        arr.push_front(step);
+        expected.push_front(step);
+      }
+    }
+    else if (operation < 2) {
+      arr.pop_back();
+      expected.pop_back();
+    }
+    else {
+      arr.pop_front();
+      expected.pop_front();
+    }
+
+    REQUIRE(arr.size() == expected.size());
+    if (!expected.empty()) {
+      REQUIRE(arr.front() == expected.front());
+      REQUIRE(arr.back() == expected.back());
+    }
+  }
+
+  requireSameElements(arr, expected);
+}
+
+TEST_CASE("segmented_array elements do not move when the array grows", "[segmented_array]")
+{
+  small_array<std::string> arr;
+  arr.push_back("first");
+  arr.push_front("second");
+
+  std::string* first = &arr.back();
+  std::string* second = &arr.front();
+
+  for (int i = 0; i < 10'000; ++i) {
+    arr.push_back(std::to_string(i));
+    arr.push_front(std::to_string(-i));
+  }
+
+  CHECK(&arr[10'000] == second);
+  CHECK(&arr[10'001] == first);
+  CHECK(*first == "first");
+  CHECK(*second == "second");
+}
+
+TEST_CASE("segmented_array does not allocate at a block boundary every time", "[segmented_array]")
+{
+  small_array<int> arr;
+  for (int i = 0; i < 16; ++i)
+    arr.push_back(i);
+
+  const size_t capacity = arr.capacity();
+
+  for (int i = 0; i < 100; ++i) {
+    arr.push_back(i);
+    arr.pop_back();
+    arr.push_front(i);
+    arr.pop_front();
+  }
+
+  CHECK(arr.capacity() <= capacity + 2 * arr.block_size());
+}
+
+TEST_CASE("segmented_array used as a queue keeps a bounded number of blocks", "[segmented_array]")
+{
+  small_array<int> arr;
+  std::deque<int> expected;
+
+  for (int i = 0; i < 100'000; ++i) {
+    arr.push_back(i);
+    expected.push_back(i);
+
+    if (arr.size() > 50) {
+      arr.pop_front();
+      expected.pop_front();
+    }
+
+    REQUIRE(arr.capacity() <= 50 + 3 * arr.block_size());
+  }
+
+  requireSameElements(arr, expected);
+}
+
+TEST_CASE("segmented_array::push_back_n() appends block by block", "[segmented_array]")
+{
+  const size_t count = GENERATE(size_t(0), size_t(1), size_t(7), size_t(8), size_t(9), size_t(100));
+
+  small_array<int> arr;
+  std::deque<int> expected;
+
+  // Start in the middle of a block
+  for (int i = 0; i < 3; ++i) {
+    arr.push_back(-i);
+    expected.push_back(-i);
+  }
+
+  std::vector<int> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = static_cast<int>(i);
+    expected.push_back(values[i]);
+  }
+
+  arr.push_back_n(values.data(), count);
+  requireSameElements(arr, expected);
+}
+
+TEST_CASE("segmented_array::push_back_n() accepts elements of the same array", "[segmented_array]")
+{
+  small_array<int> arr;
+  for (int i = 0; i < 8; ++i)
+    arr.push_back(i);
+
+  // The first block is full, so all of it can be passed at once
+  arr.push_back_n(&arr.front(), 8);
+
+  REQUIRE(arr.size() == 16);
+  for (size_t i = 0; i < 16; ++i)
+    REQUIRE(arr[i] == static_cast<int>(i % 8));
+}
+
+
+//----------------------------------------------------------------------
+// Iteration
+//
+
+TEST_CASE("segmented_array::for_each_block() visits contiguous runs in order", "[segmented_array]")
+{
+  small_array<int> arr;
+  for (int i = 0; i < 30; ++i)
+    arr.push_back(i);
+  for (int i = 1; i <= 5; ++i)
+    arr.push_front(-i);
+
+  std::vector<size_t> runs;
+  int next = -5;
+
+  arr.for_each_block([&](const int* values, size_t count) {
+    runs.push_back(count);
+    for (size_t i = 0; i < count; ++i)
+      REQUIRE(values[i] == next++);
+  });
+
+  CHECK(next == 30);
+  CHECK(runs == std::vector<size_t>{ 5, 8, 8, 8, 6 });
+}
+
+TEST_CASE("segmented_array::for_each() can modify the elements", "[segmented_array]")
+{
+  small_array<int> arr;
+  for (int i = 0; i < 20; ++i)
+    arr.push_back(i);
+
+  arr.for_each([](int& value) { value *= 2; });
+
+  for (size_t i = 0; i < 20; ++i)
+    REQUIRE(arr[i] == static_cast<int>(2 * i));
+}
+
+
+//----------------------------------------------------------------------
+// Copying, moving and releasing memory
+//
+
+TEST_CASE("segmented_array copy and move operations", "[segmented_array]")
+{
+  small_array<std::string> arr;
+  std::deque<std::string> expected;
+  for (int i = 0; i < 30; ++i) {
+    arr.push_front(std::to_string(i));
+    expected.push_front(std::to_string(i));
+  }
+
+  SECTION("copy constructor") {
+    small_array<std::string> copy(arr);
+    requireSameElements(copy, expected);
+    CHECK(&copy.front() != &arr.front());
+  }
+  SECTION("copy assignment") {
+    small_array<std::string> copy;
+    copy.push_back("replaced");
+    copy = arr;
+    requireSameElements(copy, expected);
+  }
+  SECTION("move constructor keeps the element addresses") {
+    std::string* front = &arr.front();
+    small_array<std::string> moved(std::move(arr));
+
+    CHECK(arr.empty());
+    CHECK(&moved.front() == front);
+    requireSameElements(moved, expected);
+  }
+  SECTION("move assignment") {
+    small_array<std::string> moved;
+    moved.push_back("replaced");
+    moved = std::move(arr);
+
+    CHECK(arr.empty());
+    requireSameElements(moved, expected);
+  }
+}
+
+TEST_CASE("segmented_array::shrink_to_fit() releases unused blocks", "[segmented_array]")
+{
+  small_array<int> arr;
+  for (int i = 0; i < 100; ++i)
+    arr.push_back(i);
+  for (int i = 0; i < 100; ++i)
+    arr.push_front(-i);
+
+  for (int i = 0; i < 90; ++i) {
+    arr.pop_back();
+    arr.pop_front();
+  }
+
+  int* front = &arr.front();
+  arr.shrink_to_fit();
+
+  // 20 elements which may start anywhere in a block
+  CHECK(arr.block_count() <= 4);
+  CHECK(&arr.front() == front);
+  CHECK(arr.front() == -9);
+  CHECK(arr.back() == 9);
+
+  // The array keeps working after the blocks were moved in the map
+  arr.push_front(-10);
+  arr.push_back(10);
+  CHECK(arr.size() == 22);
+  CHECK(arr[0] == -10);
+  CHECK(arr[21] == 10);
+
+  arr.clear();
+  CHECK(arr.empty());
+  CHECK(arr.capacity() == 0);
+}
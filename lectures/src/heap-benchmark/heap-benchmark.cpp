@@ -0,0 +1,134 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include "containers/priority_queue.h"
+#include "utils/random.h"
+#include "utils/stopwatch.h"
+
+// Small queues are processed several times, so that every measurement
+// handles at least this many elements and takes a measurable time
+const size_t min_elements_per_measurement = 10'000'000;
+
+///
+/// Runs a benchmark and prints how long it took.
+///
+/// The function returns a value computed from the elements, which is
+/// printed as well, so that the compiler cannot optimize the work away.
+///
+template <typename Function>
+void measure(const char* name, Function benchmark)
+{
+    stopwatch sw;
+
+    std::cout << name << "...";
+
+    sw.start();
+    unsigned long long checksum = benchmark();
+    sw.stop();
+
+    std::cout << "\n    execution took " << sw << " (checksum " << checksum << ")\n\n";
+}
+
+std::vector<int> random_values(size_t count)
+{
+    std::vector<int> values(count);
+    uint64_t state = 12345;
+
+    for (int& value : values)
+        value = static_cast<int>(nextRandom(state));
+
+    return values;
+}
+
+/// Pushes all values one by one and then pops all of them
+template <typename Queue>
+unsigned long long push_then_pop(const std::vector<int>& values, size_t repeats)
+{
+    unsigned long long sum = 0;
+
+    for (size_t r = 0; r < repeats; ++r) {
+        Queue queue;
+
+        for (int value : values)
+            queue.push(value);
+
+        while (!queue.empty()) {
+            sum += queue.top();
+            queue.pop();
+        }
+    }
+
+    return sum;
+}
+
+/// Builds the queue from all values at once and then pops all of them
+template <typename Queue>
+unsigned long long build_then_pop(const std::vector<int>& values, size_t repeats)
+{
+    unsigned long long sum = 0;
+
+    for (size_t r = 0; r < repeats; ++r) {
+        Queue queue = [&values]() {
+            if constexpr (std::is_same_v<Queue, std::priority_queue<int>>)
+                return Queue(values.begin(), values.end());
+            else
+                return Queue(values.data(), values.size());
+        }();
+
+        while (!queue.empty()) {
+            sum += queue.top();
+            queue.pop();
+        }
+    }
+
+    return sum;
+}
+
+void run_benchmarks(size_t count)
+{
+    const std::vector<int> values = random_values(count);
+    const size_t repeats = std::max<size_t>(1, min_elements_per_measurement / count);
+
+    std::cout << "=== " << count << " elements, repeated " << repeats << " times ===\n\n";
+
+    measure("std::priority_queue, push then pop", [&]() {
+        return push_then_pop<std::priority_queue<int>>(values, repeats);
+    });
+
+    measure("dsa::priority_queue, binary heap, push then pop", [&]() {
+        return push_then_pop<dsa::priority_queue<int, std::less<int>, 2>>(values, repeats);
+    });
+
+    measure("dsa::priority_queue, 4-ary heap, push then pop", [&]() {
+        return push_then_pop<dsa::priority_queue<int, std::less<int>, 4>>(values, repeats);
+    });
+
+    measure("std::priority_queue, built from a range, then pop", [&]() {
+        return build_then_pop<std::priority_queue<int>>(values, repeats);
+    });
+
+    measure("dsa::priority_queue, 4-ary heap, built from a range, then pop", [&]() {
+        return build_then_pop<dsa::priority_queue<int, std::less<int>, 4>>(values, repeats);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxCount = 100'000'000;
+
+    // The largest number of elements can be passed as an optional argument
+    if (argc > 1 && ! sscanf(argv[1], "%zu", &maxCount)) {
+        std::cerr << "Usage: " << argv[0] << " [max_element_count]\n";
+        return 1;
+    }
+
+    for (size_t count = 1000; count <= maxCount; count *= 10)
+        run_benchmarks(count);
+
+    return 0;
+}
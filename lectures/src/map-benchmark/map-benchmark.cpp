@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "containers/bplus_tree.h"
+#include "containers/flat_map.h"
+#include "utils/random.h"
+#include "utils/stopwatch.h"
+
+// Number of lookups in every measurement
+const size_t lookup_count = 10'000'000;
+
+///
+/// Runs a benchmark and prints how long it took.
+///
+/// The function returns a value computed from the elements, which is
+/// printed as well, so that the compiler cannot optimize the work away.
+///
+template <typename Function>
+void measure(const char* name, Function benchmark)
+{
+    stopwatch sw;
+
+    std::cout << name << "...";
+
+    sw.start();
+    unsigned long long checksum = benchmark();
+    sw.stop();
+
+    std::cout << "\n    execution took " << sw << " (checksum " << checksum << ")\n\n";
+}
+
+std::vector<uint64_t> random_keys(size_t count, uint64_t seed)
+{
+    std::vector<uint64_t> keys(count);
+
+    for (uint64_t& key : keys)
+        key = nextRandom64(seed) >> 16;
+
+    return keys;
+}
+
+void run_benchmarks(size_t count)
+{
+    const std::vector<uint64_t> keys = random_keys(count, 1);
+    const std::vector<uint64_t> values(count, 1);
+
+    // Half of the looked up keys are in the map
+    std::vector<uint64_t> lookups = random_keys(lookup_count, 2);
+    for (size_t i = 0; i < lookup_count; i += 2)
+        lookups[i] = keys[lookups[i] % count];
+
+    std::cout << "=== " << count << " entries, " << lookup_count << " lookups ===\n\n";
+
+    // Besides the entry, a node of std::map holds three pointers and a color
+    // (padded to the size of a pointer) and the allocator adds about 16 bytes
+    const size_t nodeBytes = 4 * sizeof(void*) + sizeof(std::pair<const uint64_t, uint64_t>) + 16;
+    const size_t flatBytes = sizeof(uint64_t) + sizeof(uint64_t);
+
+    std::cout << "Memory per entry: about " << nodeBytes << " bytes in std::map, "
+              << flatBytes << " bytes in dsa::flat_map\n\n";
+
+    std::map<uint64_t, uint64_t> nodeMap;
+    dsa::flat_map<uint64_t, uint64_t> flatMap;
+    dsa::bplus_tree<uint64_t, uint64_t> tree;
+
+    measure("std::map, insert one by one", [&]() {
+        for (size_t i = 0; i < count; ++i)
+            nodeMap.emplace(keys[i], values[i]);
+        return static_cast<unsigned long long>(nodeMap.size());
+    });
+
+    measure("dsa::flat_map, bulk construction", [&]() {
+        flatMap = dsa::flat_map<uint64_t, uint64_t>(keys.data(), values.data(), count);
+        return static_cast<unsigned long long>(flatMap.size());
+    });
+
+    measure("dsa::bplus_tree, bulk load (including sorting the keys)", [&]() {
+        dsa::dynamic_array<uint64_t> sortedKeys(count);
+        dsa::dynamic_array<uint64_t> sortedValues(count);
+
+        std::copy(keys.begin(), keys.end(), sortedKeys.data());
+        std::sort(sortedKeys.data(), sortedKeys.data() + count);
+        size_t unique = std::unique(sortedKeys.data(), sortedKeys.data() + count) - sortedKeys.data();
+
+        sortedKeys.resize(unique);
+        sortedValues.resize(unique);
+        std::fill(sortedValues.data(), sortedValues.data() + unique, 1);
+
+        tree.bulk_load(sortedKeys, sortedValues);
+        return static_cast<unsigned long long>(tree.size());
+    });
+
+    measure("std::map, lookups", [&]() {
+        unsigned long long found = 0;
+        for (uint64_t key : lookups) {
+            auto it = nodeMap.find(key);
+            found += it != nodeMap.end() ? it->second : 0;
+        }
+        return found;
+    });
+
+    measure("dsa::flat_map, lookups", [&]() {
+        unsigned long long found = 0;
+        for (uint64_t key : lookups) {
+            const uint64_t* value = flatMap.find(key);
+            found += value ? *value : 0;
+        }
+        return found;
+    });
+
+    measure("dsa::bplus_tree, lookups", [&]() {
+        unsigned long long found = 0;
+        for (uint64_t key : lookups) {
+            const uint64_t* value = tree.find(key);
+            found += value ? *value : 0;
+        }
+        return found;
+    });
+
+    measure("std::map, scan of all entries", [&]() {
+        unsigned long long sum = 0;
+        for (const auto& [key, value] : nodeMap)
+            sum += key ^ value;
+        return sum;
+    });
+
+    measure("dsa::bplus_tree, scan of all entries through the linked leaves", [&]() {
+        unsigned long long sum = 0;
+        tree.for_each([&sum](uint64_t key, uint64_t value) { sum += key ^ value; });
+        return sum;
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxCount = 10'000'000;
+
+    // The largest number of entries can be passed as an optional argument
+    if (argc > 1 && ! sscanf(argv[1], "%zu", &maxCount)) {
+        std::cerr << "Usage: " << argv[0] << " [max_entry_count]\n";
+        return 1;
+    }
+
+    for (size_t count = 10'000; count <= maxCount; count *= 10)
+        run_benchmarks(count);
+
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <queue>
+#include <stack>
+#include <stdexcept>
+
+#include "containers/list.h"
+#include "containers/resizing_stack.h"
+#include "containers/ring_deque.h"
+#include "containers/segmented_array.h"
+#include "utils/stopwatch.h"
+
+// Number of elements transferred by one push_n/pop_n call
+const size_t chunk_size = 256;
+
+///
+/// Runs a benchmark and prints how long it took.
+///
+/// The function returns a value computed from the elements, which is
+/// printed as well, so that the compiler cannot optimize the work away.
+///
+template <typename Function>
+void measure(const char* name, Function benchmark)
+{
+    stopwatch sw;
+
+    std::cout << name << "...";
+
+    sw.start();
+    unsigned long long checksum = benchmark();
+    sw.stop();
+
+    std::cout << "\n    execution took " << sw << " (checksum " << checksum << ")\n\n";
+}
+
+void run_stack_benchmarks(size_t count)
+{
+    std::cout << "=== Stacks: push " << count << " elements, then pop all of them ===\n\n";
+
+    measure("dsa::resizing_stack, one element at a time", [count]() {
+        dsa::resizing_stack<int> stack;
+        unsigned long long sum = 0;
+
+        for (size_t i = 0; i < count; ++i)
+            stack.push(static_cast<int>(i));
+
+        while (!stack.empty()) {
+            sum += stack.top();
+            stack.pop();
+        }
+
+        return sum;
+    });
+
+    measure("dsa::resizing_stack, push_n/pop_n", [count]() {
+        dsa::resizing_stack<int> stack;
+        unsigned long long sum = 0;
+        int chunk[chunk_size];
+
+        for (size_t i = 0; i < count; i += chunk_size) {
+            size_t n = std::min(chunk_size, count - i);
+            for (size_t j = 0; j < n; ++j)
+                chunk[j] = static_cast<int>(i + j);
+            stack.push_n(chunk, n);
+        }
+
+        while (size_t n = stack.pop_n(chunk, chunk_size)) {
+            for (size_t j = 0; j < n; ++j)
+                sum += chunk[j];
+        }
+
+        return sum;
+    });
+
+    measure("list (linked nodes), push_front/pop_front", [count]() {
+        list<int> stack;
+        unsigned long long sum = 0;
+
+        for (size_t i = 0; i < count; ++i)
+            stack.push_front(static_cast<int>(i));
+
+        while (stack.size() > 0) {
+            sum += stack.front();
+            stack.pop_front();
+        }
+
+        return sum;
+    });
+
+    measure("std::stack", [count]() {
+        std::stack<int> stack;
+        unsigned long long sum = 0;
+
+        for (size_t i = 0; i < count; ++i)
+            stack.push(static_cast<int>(i));
+
+        while (!stack.empty()) {
+            sum += stack.top();
+            stack.pop();
+        }
+
+        return sum;
+    });
+}
+
+void run_queue_benchmarks(size_t count)
+{
+    // The queue is kept short, so that the elements keep wrapping around the buffer
+    const size_t window = 1000;
+
+    std::cout << "=== Queues: pass " << count << " elements through a queue of " << window << " ===\n\n";
+
+    measure("dsa::ring_deque, one element at a time", [count, window]() {
+        dsa::ring_deque<int> queue;
+        unsigned long long sum = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            queue.push_back(static_cast<int>(i));
+            if (queue.size() > window) {
+                sum += queue.front();
+                queue.pop_front();
+            }
+        }
+
+        while (!queue.empty()) {
+            sum += queue.front();
+            queue.pop_front();
+        }
+
+        return sum;
+    });
+
+    measure("dsa::ring_deque, push_back_n/pop_front_n", [count, window]() {
+        dsa::ring_deque<int> queue;
+        unsigned long long sum = 0;
+        int chunk[chunk_size];
+
+        for (size_t i = 0; i < count; i += chunk_size) {
+            size_t n = std::min(chunk_size, count - i);
+            for (size_t j = 0; j < n; ++j)
+                chunk[j] = static_cast<int>(i + j);
+            queue.push_back_n(chunk, n);
+
+            if (queue.size() > window) {
+                n = queue.pop_front_n(chunk, chunk_size);
+                for (size_t j = 0; j < n; ++j)
+                    sum += chunk[j];
+            }
+        }
+
+        while (size_t n = queue.pop_front_n(chunk, chunk_size)) {
+            for (size_t j = 0; j < n; ++j)
+                sum += chunk[j];
+        }
+
+        return sum;
+    });
+
+    measure("std::queue", [count, window]() {
+        std::queue<int> queue;
+        unsigned long long sum = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            queue.push(static_cast<int>(i));
+            if (queue.size() > window) {
+                sum += queue.front();
+                queue.pop();
+            }
+        }
+
+        while (!queue.empty()) {
+            sum += queue.front();
+            queue.pop();
+        }
+
+        return sum;
+    });
+}
+
+///
+/// Appends count elements to the array one at a time and prints how long
+/// the slowest chunk_size consecutive pushes took. For an array which
+/// relocates its elements, that is the chunk which crossed the last
+/// doubling boundary.
+///
+template <typename Array>
+unsigned long long push_back_all(Array& arr, size_t count)
+{
+    using clock = std::chrono::steady_clock;
+
+    clock::duration slowest {};
+
+    for (size_t i = 0; i < count; i += chunk_size) {
+        size_t n = std::min(chunk_size, count - i);
+
+        clock::time_point start = clock::now();
+        for (size_t j = 0; j < n; ++j)
+            arr.push_back(static_cast<int>(i + j));
+        slowest = std::max(slowest, clock::now() - start);
+    }
+
+    std::cout << "\n    the slowest " << chunk_size << " pushes took "
+              << std::chrono::duration_cast<std::chrono::microseconds>(slowest).count() << "us";
+
+    return count == 0 ? 0 : arr.size() + arr[count / 2];
+}
+
+void run_growth_benchmarks(size_t count)
+{
+    std::cout << "=== Growing arrays: push_back " << count << " elements ===\n\n";
+
+    measure("dsa::dynamic_array (copies all elements when the buffer doubles)", [count]() {
+        dsa::dynamic_array<int> arr;
+        return push_back_all(arr, count);
+    });
+
+    measure("dsa::segmented_array (allocates one block at a time)", [count]() {
+        dsa::segmented_array<int> arr;
+        return push_back_all(arr, count);
+    });
+
+    measure("std::deque", [count]() {
+        std::deque<int> arr;
+        return push_back_all(arr, count);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = 10'000'000;
+
+    // The number of elements can be passed as an optional argument
+    if (argc > 1 && ! sscanf(argv[1], "%zu", &count)) {
+        std::cerr << "Usage: " << argv[0] << " [element_count]\n";
+        return 1;
+    }
+
+    run_stack_benchmarks(count);
+    run_queue_benchmarks(count);
+    run_growth_benchmarks(count);
+
+    return 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <unordered_set>
 #include <utility>
 #include <stdexcept>
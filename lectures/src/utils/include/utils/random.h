@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+//----------------------------------------------------------------------
+// A small, repeatable pseudo-random generator for tests and benchmarks
+//
+
+///
+/// Advances a 64-bit linear congruential generator (Knuth's MMIX constants)
+/// @return 31 pseudo-random bits (the low bits of an LCG are not random)
+///
+inline uint64_t nextRandom(uint64_t& state)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33;
+}
+
+/// Like nextRandom, but returns 64 bits, with the low ones mixed from the high ones
+inline uint64_t nextRandom64(uint64_t& state)
+{
+    nextRandom(state);
+    return state ^ (state >> 29);
+}
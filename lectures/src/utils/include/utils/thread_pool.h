@@ -0,0 +1,627 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+///
+/// @brief A unit of work which is executed once by a thread_pool
+///
+/// Tasks are not allocated by the pool: the code that forks them keeps them
+/// on its own stack and waits for them to complete before returning.
+///
+class pool_task {
+    void (*m_run)(pool_task*);
+    std::atomic<bool> m_done = false;
+    std::exception_ptr m_error;
+
+    template <typename F>
+    friend class function_task;
+    friend class thread_pool;
+
+protected:
+    explicit pool_task(void (*run)(pool_task*)) noexcept
+        : m_run(run)
+    {}
+
+public:
+    pool_task(const pool_task&) = delete;
+    pool_task& operator=(const pool_task&) = delete;
+
+    bool done() const noexcept
+    {
+        return m_done.load(std::memory_order_acquire);
+    }
+
+    /// Runs the task, storing any exception it throws, and marks it as done
+    void execute() noexcept
+    {
+        try {
+            m_run(this);
+        }
+        catch (...) {
+            m_error = std::current_exception();
+        }
+
+        // The task may be destroyed by its owner as soon as this is visible,
+        // so it must be the last access to the object
+        m_done.store(true, std::memory_order_release);
+    }
+
+    /// Rethrows the exception thrown by the task, if any
+    void rethrow_error() const
+    {
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+};
+
+/// A task which calls a function object (kept by reference)
+template <typename F>
+class function_task : public pool_task {
+    F& m_function;
+
+    static void run(pool_task* task)
+    {
+        static_cast<function_task*>(task)->m_function();
+    }
+
+public:
+    explicit function_task(F& function) noexcept
+        : pool_task(&run), m_function(function)
+    {}
+};
+
+///
+/// @brief Chase-Lev work-stealing deque
+///
+/// The owner thread pushes and takes tasks at the bottom (LIFO), without
+/// locks and almost always without contended atomic operations. Other
+/// threads steal from the top (FIFO), so they get the oldest - usually the
+/// largest - pieces of work. A compare-and-swap on `top` decides who gets
+/// the last element when the owner and a thief race for it.
+///
+/// The buffer grows when it is full. Old buffers may still be read by
+/// thieves, so they are kept until the deque is destroyed.
+///
+/// Based on D. Chase, Y. Lev "Dynamic Circular Work-Stealing Deque" and
+/// the C11 version by N. M. Le et al. "Correct and Efficient Work-Stealing
+/// for Weak Memory Models".
+///
+class work_stealing_deque {
+
+    struct buffer {
+        int64_t m_capacity;
+        std::unique_ptr<std::atomic<pool_task*>[]> m_slots;
+
+        explicit buffer(int64_t capacity)
+            : m_capacity(capacity), m_slots(new std::atomic<pool_task*>[capacity])
+        {}
+
+        pool_task* get(int64_t index) const noexcept
+        {
+            return m_slots[index & (m_capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, pool_task* task) noexcept
+        {
+            m_slots[index & (m_capacity - 1)].store(task, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> m_top = 0;
+    alignas(64) std::atomic<int64_t> m_bottom = 0;
+    std::atomic<buffer*> m_buffer;
+    std::vector<std::unique_ptr<buffer>> m_buffers; // the current one and all retired ones
+
+public:
+    explicit work_stealing_deque(int64_t initialCapacity = 256)
+    {
+        m_buffers.push_back(std::make_unique<buffer>(initialCapacity));
+        m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    /// Owner only
+    void push(pool_task* task)
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_acquire);
+        buffer* current = m_buffer.load(std::memory_order_relaxed);
+
+        if (bottom - top > current->m_capacity - 1)
+            current = grow(current, top, bottom);
+
+        current->put(bottom, task);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    /// Owner only. Returns nullptr if the deque is empty.
+    pool_task* take() noexcept
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        buffer* current = m_buffer.load(std::memory_order_relaxed);
+
+        // Reserve the bottom element before looking at top
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) { // empty
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        pool_task* task = current->get(bottom);
+
+        if (top == bottom) {
+            // The last element - a thief may be taking it at the same time
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                task = nullptr;
+
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return task;
+    }
+
+    /// Any thread. Returns nullptr if the deque is empty or another thread won the race.
+    pool_task* steal() noexcept
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+            return nullptr;
+
+        pool_task* task = m_buffer.load(std::memory_order_acquire)->get(top);
+
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+
+        return task;
+    }
+
+    /// May be out of date as soon as it returns
+    bool empty() const noexcept
+    {
+        return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+    }
+
+private:
+    buffer* grow(buffer* old, int64_t top, int64_t bottom)
+    {
+        m_buffers.push_back(std::make_unique<buffer>(old->m_capacity * 2));
+        buffer* bigger = m_buffers.back().get();
+
+        for (int64_t i = top; i < bottom; ++i)
+            bigger->put(i, old->get(i));
+
+        m_buffer.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+};
+
+///
+/// @brief Work-stealing thread pool for fork/join parallelism
+///
+/// Every worker thread owns a work_stealing_deque. Work forked by a worker
+/// goes to its own deque; an idle worker steals from the others. A thread
+/// which waits for forked work does not block - it executes other tasks in
+/// the meantime - so nested parallel_invoke and parallel_for calls do not
+/// deadlock and keep all workers busy.
+///
+/// Calls from threads outside the pool are handed to a worker through a
+/// shared queue and the calling thread blocks until they complete.
+///
+/// Use thread_pool::shared() to get one pool for the whole program,
+/// instead of creating threads in every algorithm.
+///
+class thread_pool {
+
+    struct worker {
+        work_stealing_deque m_tasks;
+        std::thread m_thread;
+    };
+
+    std::vector<std::unique_ptr<worker>> m_workers;
+
+    // Tasks submitted by threads which are not workers of this pool
+    std::mutex m_injectedMutex;
+    std::deque<pool_task*> m_injected;
+    std::atomic<size_t> m_injectedCount = 0;
+
+    // The threads which injected tasks wait here for them to complete
+    std::mutex m_injectedDoneMutex;
+    std::condition_variable m_injectedDone;
+
+    // Sleeping when there is no work
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeUp;
+    std::atomic<size_t> m_sleepers = 0;
+    uint64_t m_wakeSignals = 0;
+    bool m_stopping = false;
+
+    /// Number of unsuccessful searches for work before a worker goes to sleep
+    static constexpr int spins_before_sleep = 64;
+
+public:
+    /// Creates a pool with threadCount workers (at least one)
+    explicit thread_pool(size_t threadCount = std::thread::hardware_concurrency())
+    {
+        threadCount = std::max<size_t>(threadCount, 1);
+
+        for (size_t i = 0; i < threadCount; ++i)
+            m_workers.push_back(std::make_unique<worker>());
+
+        try {
+            for (size_t i = 0; i < threadCount; ++i)
+                m_workers[i]->m_thread = std::thread(&thread_pool::worker_loop, this, i);
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// Waits for the workers to finish. No work may be in progress.
+    ~thread_pool()
+    {
+        stop();
+    }
+
+    /// A pool with one worker per hardware thread, created on first use
+    static thread_pool& shared()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    size_t thread_count() const noexcept
+    {
+        return m_workers.size();
+    }
+
+    ///
+    /// @brief Runs all functions, possibly in parallel, and waits for them
+    ///
+    /// If some of the functions throw, the first exception (in argument
+    /// order) is rethrown after all of them have finished.
+    ///
+    template <typename... Functions>
+    void parallel_invoke(Functions&&... functions)
+    {
+        run_in_pool([&]() { fork_join(functions...); });
+    }
+
+    ///
+    /// @brief Calls body(blockBegin, blockEnd) for blocks which cover [first, last)
+    ///
+    /// The range is split in halves recursively until the blocks contain at
+    /// most grainSize indices. Idle workers steal the larger halves. With
+    /// grainSize = 0 the size is chosen so that there are about 8 blocks per worker.
+    ///
+    template <typename Body>
+    void parallel_for_blocks(size_t first, size_t last, size_t grainSize, Body&& body)
+    {
+        if (first >= last)
+            return;
+
+        if (grainSize == 0)
+            grainSize = default_grain_size(last - first);
+
+        run_in_pool([&]() { split(first, last, grainSize, body); });
+    }
+
+    /// Calls body(i) for every i in [first, last), in parallel.
+    /// See parallel_for_blocks() for the meaning of grainSize.
+    template <typename Body>
+    void parallel_for(size_t first, size_t last, size_t grainSize, Body&& body)
+    {
+        parallel_for_blocks(first, last, grainSize, [&body](size_t blockBegin, size_t blockEnd) {
+            for (size_t i = blockBegin; i < blockEnd; ++i)
+                body(i);
+        });
+    }
+
+    /// A grain size which gives about 8 blocks per worker
+    size_t default_grain_size(size_t count) const noexcept
+    {
+        return std::max<size_t>(1, count / (8 * thread_count()));
+    }
+
+private:
+    /// Index of the calling thread among the workers of this pool, or -1
+    int64_t current_worker() const noexcept
+    {
+        return this == tls_pool() ? tls_index() : -1;
+    }
+
+    static const thread_pool*& tls_pool() noexcept
+    {
+        static thread_local const thread_pool* pool = nullptr;
+        return pool;
+    }
+
+    static int64_t& tls_index() noexcept
+    {
+        static thread_local int64_t index = -1;
+        return index;
+    }
+
+    /// Runs function on a worker of this pool and waits for it
+    template <typename F>
+    void run_in_pool(F&& function)
+    {
+        if (current_worker() >= 0) {
+            function();
+            return;
+        }
+
+        function_task<F> task(function);
+        inject(&task);
+
+        {
+            std::unique_lock<std::mutex> lock(m_injectedDoneMutex);
+            m_injectedDone.wait(lock, [&task]() { return task.done(); });
+        }
+
+        task.rethrow_error();
+    }
+
+    /// Runs the first function here and the others as tasks that can be stolen
+    template <typename First, typename... Rest>
+    void fork_join(First& first, Rest&... rest)
+    {
+        if constexpr (sizeof...(Rest) == 0) {
+            first();
+        }
+        else {
+            std::tuple<function_task<Rest>...> tasks(rest...);
+
+            std::apply([this](auto&... task) { (push_local(&task), ...); }, tasks);
+
+            std::exception_ptr firstError;
+            try {
+                first();
+            }
+            catch (...) {
+                firstError = std::current_exception();
+            }
+
+            // Join in the reverse order of pushing, so the tasks which were
+            // not stolen are taken back from the bottom of the deque
+            std::apply([this](auto&... task) {
+                pool_task* joined[] = { &task... };
+                for (size_t i = sizeof...(Rest); i-- > 0;)
+                    wait_for(*joined[i]);
+            }, tasks);
+
+            if (firstError)
+                std::rethrow_exception(firstError);
+
+            std::apply([](auto&... task) { (task.rethrow_error(), ...); }, tasks);
+        }
+    }
+
+    template <typename Body>
+    void split(size_t first, size_t last, size_t grainSize, Body& body)
+    {
+        while (last - first > grainSize) {
+            size_t middle = first + (last - first) / 2;
+
+            // The right half can be stolen; this thread continues with the left half
+            auto right = [&, middle, last]() { split(middle, last, grainSize, body); };
+            function_task<decltype(right)> task(right);
+            push_local(&task);
+
+            std::exception_ptr error;
+            try {
+                split(first, middle, grainSize, body);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            wait_for(task);
+
+            if (error)
+                std::rethrow_exception(error);
+            task.rethrow_error();
+            return;
+        }
+
+        body(first, last);
+    }
+
+    /// Pushes a task to the deque of the calling worker
+    void push_local(pool_task* task)
+    {
+        m_workers[current_worker()]->m_tasks.push(task);
+        wake_one_if_sleeping();
+    }
+
+    void inject(pool_task* task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_injectedMutex);
+            m_injected.push_back(task);
+            m_injectedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake_one_if_sleeping();
+    }
+
+    /// Waits for a task to complete, executing other tasks in the meantime
+    void wait_for(pool_task& task)
+    {
+        int64_t self = current_worker();
+
+        while (!task.done()) {
+            // Most often the task was not stolen and is on the bottom of the deque
+            if (pool_task* next = m_workers[self]->m_tasks.take())
+                next->execute();
+            else if (pool_task* stolen = steal(self))
+                stolen->execute();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    pool_task* take_injected()
+    {
+        if (m_injectedCount.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(m_injectedMutex);
+        if (m_injected.empty())
+            return nullptr;
+
+        pool_task* task = m_injected.front();
+        m_injected.pop_front();
+        m_injectedCount.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    /// Tries the other workers' deques once, starting from a random one
+    pool_task* steal(int64_t self)
+    {
+        static thread_local std::minstd_rand generator(std::random_device{}());
+
+        size_t count = m_workers.size();
+        size_t start = generator() % count;
+
+        for (size_t i = 0; i < count; ++i) {
+            size_t victim = (start + i) % count;
+            if (static_cast<int64_t>(victim) == self)
+                continue;
+
+            if (pool_task* task = m_workers[victim]->m_tasks.steal())
+                return task;
+        }
+
+        return nullptr;
+    }
+
+    /// injected is set to whether the task came from another thread
+    pool_task* find_task(int64_t self, bool& injected)
+    {
+        injected = false;
+
+        if (pool_task* task = m_workers[self]->m_tasks.take())
+            return task;
+
+        if (pool_task* task = take_injected()) {
+            injected = true;
+            return task;
+        }
+
+        return steal(self);
+    }
+
+    bool has_visible_work() const noexcept
+    {
+        if (m_injectedCount.load(std::memory_order_relaxed) != 0)
+            return true;
+
+        for (const std::unique_ptr<worker>& w : m_workers) {
+            if (!w->m_tasks.empty())
+                return true;
+        }
+
+        return false;
+    }
+
+    void worker_loop(size_t index)
+    {
+        tls_pool() = this;
+        tls_index() = static_cast<int64_t>(index);
+
+        int idleRounds = 0;
+        bool injected;
+
+        while (true) {
+            if (pool_task* task = find_task(index, injected)) {
+                task->execute();
+                if (injected)
+                    notify_injected_done();
+                idleRounds = 0;
+                continue;
+            }
+
+            if (++idleRounds < spins_before_sleep) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            if (m_stopping)
+                return;
+
+            uint64_t signals = m_wakeSignals;
+            m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Work pushed before m_sleepers was incremented might not have
+            // woken anybody, so check once more before sleeping
+            if (!has_visible_work())
+                m_wakeUp.wait(lock, [&]() { return m_wakeSignals != signals || m_stopping; });
+
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+            idleRounds = 0;
+        }
+    }
+
+    void notify_injected_done()
+    {
+        // Taking the mutex ensures the waiting thread is either before its
+        // check of done() or already waiting, so the notification is not lost
+        { std::lock_guard<std::mutex> lock(m_injectedDoneMutex); }
+        m_injectedDone.notify_all();
+    }
+
+    void wake_one_if_sleeping()
+    {
+        // Pairs with the increment of m_sleepers in worker_loop: either the
+        // worker sees the new work or this thread sees the sleeping worker
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_sleepers.load(std::memory_order_relaxed) == 0)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            ++m_wakeSignals;
+        }
+        m_wakeUp.notify_one();
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stopping = true;
+        }
+        m_wakeUp.notify_all();
+
+        for (std::unique_ptr<worker>& w : m_workers) {
+            if (w->m_thread.joinable())
+                w->m_thread.join();
+        }
+    }
+};
@@ -0,0 +1,129 @@
+#include "catch2/catch_all.hpp"
+#include "utils/thread_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Naive doubly recursive Fibonacci, which creates many small nested tasks
+long long fibonacci(thread_pool& pool, int n)
+{
+    if (n < 2)
+        return n;
+
+    long long a = 0, b = 0;
+    pool.parallel_invoke(
+        [&]() { a = fibonacci(pool, n - 1); },
+        [&]() { b = fibonacci(pool, n - 2); });
+
+    return a + b;
+}
+
+}
+
+TEST_CASE("thread_pool has at least one worker", "[thread_pool]")
+{
+    thread_pool pool(0);
+    CHECK(pool.thread_count() == 1);
+    CHECK(thread_pool::shared().thread_count() >= 1);
+}
+
+TEST_CASE("thread_pool::parallel_invoke() runs every function exactly once", "[thread_pool]")
+{
+    size_t threadCount = GENERATE(1, 2, 4);
+    thread_pool pool(threadCount);
+
+    std::atomic<int> calls[4] = {};
+
+    pool.parallel_invoke(
+        [&]() { ++calls[0]; },
+        [&]() { ++calls[1]; },
+        [&]() { ++calls[2]; },
+        [&]() { ++calls[3]; });
+
+    for (std::atomic<int>& count : calls)
+        CHECK(count == 1);
+}
+
+TEST_CASE("thread_pool::parallel_invoke() supports nested fork/join", "[thread_pool]")
+{
+    size_t threadCount = GENERATE(1, 4);
+    thread_pool pool(threadCount);
+
+    CHECK(fibonacci(pool, 20) == 6765);
+}
+
+TEST_CASE("thread_pool::parallel_invoke() rethrows exceptions after all functions finish", "[thread_pool]")
+{
+    thread_pool pool(4);
+    std::atomic<bool> otherFinished = false;
+
+    REQUIRE_THROWS_AS(
+        pool.parallel_invoke(
+            [&]() { otherFinished = true; },
+            []() { throw std::runtime_error("failure"); }),
+        std::runtime_error);
+
+    CHECK(otherFinished);
+}
+
+TEST_CASE("thread_pool::parallel_for() visits every index exactly once", "[thread_pool]")
+{
+    size_t threadCount = GENERATE(1, 3);
+    size_t grainSize = GENERATE(0, 1, 7, 100000);
+    thread_pool pool(threadCount);
+
+    const size_t count = 10000;
+    std::vector<std::atomic<int>> visits(count);
+
+    pool.parallel_for(0, count, grainSize, [&](size_t i) { ++visits[i]; });
+
+    for (size_t i = 0; i < count; ++i)
+        REQUIRE(visits[i] == 1);
+}
+
+TEST_CASE("thread_pool::parallel_for_blocks() respects the grain size", "[thread_pool]")
+{
+    thread_pool pool(2);
+    std::atomic<size_t> covered = 0;
+    std::atomic<bool> tooLarge = false;
+
+    pool.parallel_for_blocks(10, 1010, 64, [&](size_t blockBegin, size_t blockEnd) {
+        if (blockEnd - blockBegin > 64)
+            tooLarge = true;
+        covered += blockEnd - blockBegin;
+    });
+
+    CHECK(covered == 1000);
+    CHECK_FALSE(tooLarge);
+}
+
+TEST_CASE("thread_pool::parallel_for() with an empty range does nothing", "[thread_pool]")
+{
+    thread_pool pool(2);
+    bool called = false;
+
+    pool.parallel_for(5, 5, 0, [&](size_t) { called = true; });
+
+    CHECK_FALSE(called);
+}
+
+TEST_CASE("thread_pool can be used from several threads at once", "[thread_pool]")
+{
+    thread_pool pool(2);
+    std::atomic<long long> total = 0;
+    std::vector<std::thread> clients;
+
+    for (int c = 0; c < 4; ++c) {
+        clients.emplace_back([&]() {
+            pool.parallel_for(0, 1000, 10, [&](size_t i) { total += static_cast<long long>(i); });
+        });
+    }
+
+    for (std::thread& client : clients)
+        client.join();
+
+    CHECK(total == 4 * 999 * 1000 / 2);
+}